@@ -0,0 +1,144 @@
+//============================================================================
+/// \file   Benchmark.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Implementation of the benchmark helpers of the ads_benchmarks suite
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "Benchmark.h"
+
+#include <limits>
+
+#include <QApplication>
+#include <QLabel>
+#include <QMainWindow>
+
+#include "DockManager.h"
+#include "DockWidget.h"
+#include "DockAreaWidget.h"
+
+using namespace ads;
+
+
+//============================================================================
+QJsonObject BenchmarkConfig::toJson() const
+{
+	QJsonObject Object;
+	Object["dock_widgets"] = DockWidgets;
+	Object["dock_areas"] = DockAreas;
+	Object["floating_containers"] = FloatingContainers;
+	Object["iterations"] = Iterations;
+	return Object;
+}
+
+
+//============================================================================
+QJsonObject CBenchmarkResults::measure(const QString& Name, int Iterations,
+	const std::function<void(int)>& Function, const QJsonObject& Parameters)
+{
+	qint64 TotalNs = 0;
+	qint64 MinNs = std::numeric_limits<qint64>::max();
+	qint64 MaxNs = 0;
+	QElapsedTimer Timer;
+	for (int i = 0; i < Iterations; ++i)
+	{
+		Timer.start();
+		Function(i);
+		QApplication::processEvents();
+		auto Ns = Timer.nsecsElapsed();
+		TotalNs += Ns;
+		MinNs = qMin(MinNs, Ns);
+		MaxNs = qMax(MaxNs, Ns);
+	}
+
+	QJsonObject Result = Parameters;
+	Result["iterations"] = Iterations;
+	Result["avg_ns"] = Iterations ? TotalNs / Iterations : 0;
+	Result["min_ns"] = Iterations ? MinNs : 0;
+	Result["max_ns"] = MaxNs;
+	addResult(Name, Result);
+	return Result;
+}
+
+
+//============================================================================
+void CBenchmarkResults::addResult(const QString& Name, const QJsonObject& Values)
+{
+	QJsonObject Result = Values;
+	Result["name"] = Name;
+	m_Results.append(Result);
+}
+
+
+//============================================================================
+CSyntheticLayout::CSyntheticLayout(const BenchmarkConfig& Config)
+{
+	static const DockWidgetArea SplitAreas[] = {RightDockWidgetArea,
+		BottomDockWidgetArea, LeftDockWidgetArea, TopDockWidgetArea};
+
+	m_MainWindow = new QMainWindow();
+	m_DockManager = new CDockManager(m_MainWindow);
+	int DockAreaCount = qMax(1, qMin(Config.DockAreas, Config.DockWidgets));
+	int FloatingCount = qBound(0, Config.FloatingContainers,
+		Config.DockWidgets - DockAreaCount);
+	int DockedCount = Config.DockWidgets - FloatingCount;
+	QList<CDockAreaWidget*> DockAreas;
+	for (int i = 0; i < DockedCount; ++i)
+	{
+		auto DockWidget = createDockWidget(QString("DockWidget %1").arg(i));
+		if (i < DockAreaCount)
+		{
+			// Splitting the last area in alternating directions creates a
+			// nested splitter tree
+			auto TargetArea = DockAreas.isEmpty() ? nullptr : DockAreas.last();
+			DockAreas.append(m_DockManager->addDockWidget(SplitAreas[i % 4],
+				DockWidget, TargetArea));
+		}
+		else
+		{
+			m_DockManager->addDockWidgetTabToArea(DockWidget,
+				DockAreas.at(i % DockAreaCount));
+		}
+	}
+
+	for (int i = 0; i < FloatingCount; ++i)
+	{
+		auto DockWidget = createDockWidget(QString("FloatingDockWidget %1").arg(i));
+		m_DockManager->addDockWidgetFloating(DockWidget);
+	}
+
+	m_MainWindow->resize(1600, 1200);
+	m_MainWindow->show();
+	QApplication::processEvents();
+}
+
+
+//============================================================================
+CSyntheticLayout::~CSyntheticLayout()
+{
+	delete m_MainWindow;
+	QApplication::processEvents();
+}
+
+
+//============================================================================
+CDockAreaWidget* CSyntheticLayout::firstDockArea() const
+{
+	return m_DockWidgets.first()->dockAreaWidget();
+}
+
+
+//============================================================================
+CDockWidget* CSyntheticLayout::createDockWidget(const QString& Name)
+{
+	auto DockWidget = m_DockManager->createDockWidget(Name);
+	DockWidget->setWidget(new QLabel(Name));
+	m_DockWidgets.append(DockWidget);
+	return DockWidget;
+}
+
+//---------------------------------------------------------------------------
+// EOF Benchmark.cpp
@@ -0,0 +1,134 @@
+#ifndef BenchmarkH
+#define BenchmarkH
+//============================================================================
+/// \file   Benchmark.h
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Declaration of the benchmark helpers of the ads_benchmarks suite
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+QT_FORWARD_DECLARE_CLASS(QMainWindow)
+
+namespace ads
+{
+class CDockManager;
+class CDockWidget;
+class CDockAreaWidget;
+}
+
+/**
+ * Size of the synthetic layouts that are used by the benchmarks
+ */
+struct BenchmarkConfig
+{
+	int DockWidgets = 100; ///< number of dock widgets (N)
+	int DockAreas = 10; ///< number of docked dock areas (M)
+	int FloatingContainers = 2; ///< number of floating containers (K)
+	int Iterations = 20; ///< number of measured iterations per benchmark
+
+	/**
+	 * Returns the configuration as JSON object
+	 */
+	QJsonObject toJson() const;
+};
+
+
+/**
+ * Collects the timing results of all benchmarks
+ */
+class CBenchmarkResults
+{
+private:
+	QJsonArray m_Results;
+
+public:
+	/**
+	 * Calls Function Iterations times and adds the timing result with the
+	 * given name. Pending events are processed after each call, so deferred
+	 * layout work is included in the measurement.
+	 */
+	QJsonObject measure(const QString& Name, int Iterations,
+		const std::function<void(int)>& Function,
+		const QJsonObject& Parameters = QJsonObject());
+
+	/**
+	 * Adds a result that has been measured by the benchmark itself
+	 */
+	void addResult(const QString& Name, const QJsonObject& Values);
+
+	/**
+	 * Returns all results as JSON array
+	 */
+	QJsonArray toJson() const {return m_Results;}
+};
+
+
+/**
+ * Main window with a dock manager that contains a synthetic layout with
+ * N dock widgets distributed to M docked dock areas and K floating
+ * containers
+ */
+class CSyntheticLayout
+{
+private:
+	QMainWindow* m_MainWindow;
+	ads::CDockManager* m_DockManager;
+	QList<ads::CDockWidget*> m_DockWidgets;
+
+public:
+	/**
+	 * Creates and shows the layout
+	 */
+	CSyntheticLayout(const BenchmarkConfig& Config);
+
+	/**
+	 * Deletes the main window and the dock manager
+	 */
+	~CSyntheticLayout();
+
+	ads::CDockManager* dockManager() const {return m_DockManager;}
+	const QList<ads::CDockWidget*>& dockWidgets() const {return m_DockWidgets;}
+
+	/**
+	 * Returns the dock area of the first dock widget. This is the docked area
+	 * with the most tabs. Restoring a state may recreate the dock areas, so
+	 * the area pointer should not be stored.
+	 */
+	ads::CDockAreaWidget* firstDockArea() const;
+
+	/**
+	 * Creates a dock widget with a simple label as content
+	 */
+	ads::CDockWidget* createDockWidget(const QString& Name);
+};
+
+
+/**
+ * Benchmarks for state saving and restoring, perspectives, adding and
+ * removing dock widgets, tab switching and drag operations
+ */
+void runLayoutBenchmarks(CBenchmarkResults& Results, const BenchmarkConfig& Config);
+
+/**
+ * Benchmarks for focus changes depending on the content size
+ */
+void runFocusBenchmarks(CBenchmarkResults& Results, const BenchmarkConfig& Config);
+
+/**
+ * Benchmarks for tab switching depending on the tab count
+ */
+void runTabBenchmarks(CBenchmarkResults& Results, const BenchmarkConfig& Config);
+
+//---------------------------------------------------------------------------
+#endif // BenchmarkH
@@ -0,0 +1,80 @@
+//============================================================================
+/// \file   FocusBenchmarks.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Measures the focus switch latency depending on the content size
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "Benchmark.h"
+
+#include <QApplication>
+#include <QFormLayout>
+#include <QLineEdit>
+#include <QMainWindow>
+
+#include "DockManager.h"
+#include "DockWidget.h"
+
+using namespace ads;
+
+
+//============================================================================
+static QWidget* createContent(int WidgetCount)
+{
+	auto Content = new QWidget();
+	auto Layout = new QFormLayout(Content);
+	for (int i = 0; i < WidgetCount; ++i)
+	{
+		Layout->addRow(QString("Field %1").arg(i), new QLineEdit());
+	}
+	return Content;
+}
+
+
+//============================================================================
+static void runFocusBenchmark(CBenchmarkResults& Results,
+	const BenchmarkConfig& Config, int WidgetCount)
+{
+	QMainWindow MainWindow;
+	auto DockManager = new CDockManager(&MainWindow);
+
+	CDockWidget* DockWidgets[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		DockWidgets[i] = DockManager->createDockWidget(QString("Dock %1").arg(i));
+		DockWidgets[i]->setWidget(createContent(WidgetCount));
+		DockManager->addDockWidget(i ? RightDockWidgetArea : LeftDockWidgetArea,
+			DockWidgets[i]);
+	}
+	MainWindow.resize(1280, 1024);
+	MainWindow.show();
+	QApplication::processEvents();
+
+	QJsonObject Parameters;
+	Parameters["content_widgets"] = WidgetCount;
+	Results.measure("focus_switch", Config.Iterations * 5, [&](int i)
+	{
+		DockManager->setDockWidgetFocused(DockWidgets[i % 2]);
+	}, Parameters);
+}
+
+
+//============================================================================
+void runFocusBenchmarks(CBenchmarkResults& Results, const BenchmarkConfig& Config)
+{
+	// The focus controller only exists if focus highlighting is enabled
+	// when the dock manager is created
+	auto Flags = CDockManager::configFlags();
+	CDockManager::setConfigFlag(CDockManager::FocusHighlighting, true);
+	for (int WidgetCount : {0, 100, 1000, 5000})
+	{
+		runFocusBenchmark(Results, Config, WidgetCount);
+	}
+	CDockManager::setConfigFlags(Flags);
+}
+
+//---------------------------------------------------------------------------
+// EOF FocusBenchmarks.cpp
@@ -0,0 +1,325 @@
+//============================================================================
+/// \file   LayoutBenchmarks.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Benchmarks for layout operations of the dock manager
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "Benchmark.h"
+
+#include <QApplication>
+#include <QCursor>
+#include <QKeyEvent>
+#include <QMainWindow>
+#include <QSettings>
+#include <QTemporaryDir>
+
+#include "DockManager.h"
+#include "DockWidget.h"
+#include "DockAreaWidget.h"
+#include "DockingStateReader.h"
+#include "DockHitTestIndex.h"
+#include "FloatingDragPreview.h"
+#include "ElidingLabel.h"
+#include "PerspectiveStore.h"
+
+using namespace ads;
+
+
+//============================================================================
+static void runStateBenchmarks(CBenchmarkResults& Results,
+	const BenchmarkConfig& Config, CSyntheticLayout& Layout)
+{
+	auto DockManager = Layout.dockManager();
+	QByteArray XmlState;
+	QByteArray BinaryState;
+	Results.measure("save_state_xml", Config.Iterations, [&](int)
+	{
+		XmlState = DockManager->saveState();
+	});
+	Results.measure("save_state_binary", Config.Iterations, [&](int)
+	{
+		BinaryState = DockManager->saveState(0, CDockManager::BinaryStateFormat);
+	});
+
+	// With incremental saving only the floating container that has been
+	// moved is captured and encoded again
+	DockManager->setIncrementalSaveEnabled(true);
+	auto FloatingWidgets = DockManager->floatingWidgets();
+	Results.measure("save_state_xml_incremental", Config.Iterations, [&](int i)
+	{
+		if (!FloatingWidgets.isEmpty())
+		{
+			auto FloatingWidget = FloatingWidgets[i % FloatingWidgets.count()];
+			FloatingWidget->move(FloatingWidget->pos() + QPoint((i % 2) ? -1 : 1, 0));
+		}
+		XmlState = DockManager->saveState();
+	});
+	DockManager->setIncrementalSaveEnabled(false);
+
+	QJsonObject Sizes;
+	Sizes["xml_bytes"] = XmlState.size();
+	Sizes["binary_bytes"] = BinaryState.size();
+	Results.addResult("state_size", Sizes);
+
+	// Parsing is timed separately from the widget creation to see which
+	// part of restoreState() dominates
+	DockingState StateTree;
+	Results.measure("restore_state_parse", Config.Iterations, [&](int)
+	{
+		StateTree = DockingState();
+		DockManager->decodeState(XmlState, 0, StateTree);
+	});
+	Results.measure("restore_state_build", Config.Iterations, [&](int)
+	{
+		DockManager->restoreState(StateTree);
+	});
+	Results.measure("restore_state_xml", Config.Iterations, [&](int)
+	{
+		DockManager->restoreState(XmlState);
+	});
+
+	Results.measure("restore_state_binary", Config.Iterations, [&](int)
+	{
+		DockManager->restoreState(BinaryState);
+	});
+	DockManager->restoreState(XmlState);
+}
+
+
+//============================================================================
+static void runPerspectiveBenchmarks(CBenchmarkResults& Results,
+	const BenchmarkConfig& Config, CSyntheticLayout& Layout)
+{
+	auto DockManager = Layout.dockManager();
+	auto InitialState = DockManager->saveState();
+	DockManager->addPerspective("Full");
+	const auto& DockWidgets = Layout.dockWidgets();
+	for (int i = 0; i < DockWidgets.count(); i += 3)
+	{
+		DockWidgets[i]->toggleView(false);
+	}
+	DockManager->addPerspective("Reduced");
+
+	auto OpenPerspective = [&](int i)
+	{
+		DockManager->openPerspective((i % 2) ? "Full" : "Reduced");
+	};
+	Results.measure("open_perspective", Config.Iterations, OpenPerspective);
+	DockManager->setIncrementalRestoreEnabled(true);
+	Results.measure("open_perspective_incremental", Config.Iterations, OpenPerspective);
+	DockManager->setIncrementalRestoreEnabled(false);
+
+	DockManager->removePerspectives({"Full", "Reduced"});
+	DockManager->restoreState(InitialState);
+}
+
+
+//============================================================================
+static void runPerspectiveDeltaBenchmark(CBenchmarkResults& Results,
+	const BenchmarkConfig& Config, CSyntheticLayout& Layout)
+{
+	auto DockManager = Layout.dockManager();
+	auto InitialState = DockManager->saveState();
+	const auto& DockWidgets = Layout.dockWidgets();
+	const int PerspectiveCount = 20;
+	QStringList Names;
+	for (int i = 0; i < PerspectiveCount; ++i)
+	{
+		Names.append(QString("Perspective%1").arg(i));
+	}
+
+	// The same set of near identical perspectives is stored once with full
+	// states and once delta encoded
+	for (bool DeltaEncoding : {false, true})
+	{
+		const QString Encoding = DeltaEncoding ? "delta" : "full";
+		DockManager->setPerspectiveDeltaEncodingEnabled(DeltaEncoding);
+		QElapsedTimer Timer;
+		qint64 AddNs = 0;
+		for (int i = 0; i < PerspectiveCount; ++i)
+		{
+			DockManager->restoreState(InitialState);
+			DockWidgets[(i * 7) % DockWidgets.count()]->toggleView(false);
+			QApplication::processEvents();
+			Timer.start();
+			DockManager->addPerspective(Names[i]);
+			AddNs += Timer.nsecsElapsed();
+		}
+
+		qint64 StoredBytes = 0;
+		for (const auto& Name : Names)
+		{
+			StoredBytes += DockManager->perspectiveStore()->perspective(Name).size();
+		}
+
+		QTemporaryDir Dir;
+		QSettings Settings(Dir.filePath("perspectives.ini"), QSettings::IniFormat);
+		Timer.start();
+		DockManager->savePerspectives(Settings);
+		Settings.sync();
+		qint64 SaveNs = Timer.nsecsElapsed();
+
+		QJsonObject Values;
+		Values["perspectives"] = PerspectiveCount;
+		Values["stored_bytes"] = StoredBytes;
+		Values["add_avg_ns"] = AddNs / PerspectiveCount;
+		Values["settings_save_ns"] = SaveNs;
+		Results.addResult("perspective_storage_" + Encoding, Values);
+
+		Results.measure("open_perspective_" + Encoding, Config.Iterations, [&](int i)
+		{
+			DockManager->openPerspective(Names[i % PerspectiveCount]);
+		});
+		DockManager->removePerspectives(Names);
+	}
+
+	DockManager->setPerspectiveDeltaEncodingEnabled(false);
+	DockManager->restoreState(InitialState);
+}
+
+
+//============================================================================
+static void runBulkBenchmarks(CBenchmarkResults& Results,
+	const BenchmarkConfig& Config, CSyntheticLayout& Layout, bool Batched)
+{
+	auto DockManager = Layout.dockManager();
+	auto TargetArea = Layout.firstDockArea();
+	QList<QList<CDockWidget*>> Batches;
+	QJsonObject Parameters;
+	Parameters["dock_widgets"] = Config.DockWidgets;
+	Parameters["batched"] = Batched;
+
+	Results.measure("bulk_add", Config.Iterations, [&](int i)
+	{
+		if (Batched)
+		{
+			DockManager->beginLayoutUpdate();
+		}
+		QList<CDockWidget*> Batch;
+		for (int j = 0; j < Config.DockWidgets; ++j)
+		{
+			auto DockWidget = DockManager->createDockWidget(
+				QString("Bulk %1 %2").arg(i).arg(j));
+			DockManager->addDockWidgetTabToArea(DockWidget, TargetArea);
+			Batch.append(DockWidget);
+		}
+		Batches.append(Batch);
+		if (Batched)
+		{
+			DockManager->endLayoutUpdate();
+		}
+	}, Parameters);
+
+	Results.measure("bulk_remove", Config.Iterations, [&](int i)
+	{
+		if (Batched)
+		{
+			DockManager->beginLayoutUpdate();
+		}
+		for (auto DockWidget : Batches[i])
+		{
+			DockWidget->deleteDockWidget();
+		}
+		if (Batched)
+		{
+			DockManager->endLayoutUpdate();
+		}
+	}, Parameters);
+}
+
+
+//============================================================================
+static void runTabSwitchBenchmark(CBenchmarkResults& Results,
+	const BenchmarkConfig& Config, CSyntheticLayout& Layout)
+{
+	auto DockArea = Layout.firstDockArea();
+	QJsonObject Parameters;
+	Parameters["tabs"] = DockArea->dockWidgetsCount();
+	Results.measure("tab_switch", Config.Iterations * 10, [&](int i)
+	{
+		DockArea->setCurrentIndex((i + 1) % DockArea->dockWidgetsCount());
+	}, Parameters);
+}
+
+
+//============================================================================
+static void runResizeBenchmark(CBenchmarkResults& Results,
+	const BenchmarkConfig& Config, CSyntheticLayout& Layout)
+{
+	auto Window = Layout.dockManager()->window();
+	QSize Size = Window->size();
+	CElisionCache::resetCounters();
+
+	// Shrink the window in steps to force the tab titles to elide
+	Results.measure("window_resize", Config.Iterations * 5, [&](int i)
+	{
+		Window->resize(Size.width() - (i % 20) * (Size.width() / 40), Size.height());
+	});
+	Window->resize(Size);
+
+	QJsonObject Values;
+	Values["hits"] = double(CElisionCache::hitCount());
+	Values["misses"] = double(CElisionCache::missCount());
+	Values["width_bucket_size"] = CElisionCache::widthBucketSize();
+	Results.addResult("elision_cache", Values);
+}
+
+
+//============================================================================
+static void runDragBenchmark(CBenchmarkResults& Results,
+	const BenchmarkConfig& Config, CSyntheticLayout& Layout)
+{
+	auto DockManager = Layout.dockManager();
+	auto DockWidget = Layout.firstDockArea()->currentDockWidget();
+	QRect Geometry(DockManager->mapToGlobal(QPoint(0, 0)), DockManager->size());
+
+	// The preview deletes itself if the drag is canceled
+	auto DragPreview = new CFloatingDragPreview(DockWidget);
+	IFloatingWidget* FloatingWidget = DragPreview;
+	QCursor::setPos(Geometry.center());
+	FloatingWidget->startFloating(QPoint(10, 10), QSize(320, 240),
+		DraggingFloatingWidget, nullptr);
+
+	// Move the cursor on a pseudo random path over the dock manager
+	Results.measure("drag_move", Config.Iterations * 10, [&](int i)
+	{
+		QCursor::setPos(Geometry.left() + (i * 37) % Geometry.width(),
+			Geometry.top() + (i * 53) % Geometry.height());
+		FloatingWidget->moveFloating();
+	});
+
+	auto Statistics = DockManager->hitTestIndex()->statistics();
+	QJsonObject Values;
+	Values["frames"] = Statistics.Frames;
+	Values["avg_ns"] = Statistics.averageNs();
+	Values["max_ns"] = Statistics.MaxNs;
+	Values["index_builds"] = Statistics.IndexBuilds;
+	Values["overlay_repaints"] = Statistics.OverlayRepaints;
+	Results.addResult("drag_update_drop_overlays", Values);
+
+	QKeyEvent Escape(QEvent::KeyPress, Qt::Key_Escape, Qt::NoModifier);
+	QApplication::sendEvent(DragPreview, &Escape);
+	QApplication::processEvents();
+}
+
+
+//============================================================================
+void runLayoutBenchmarks(CBenchmarkResults& Results, const BenchmarkConfig& Config)
+{
+	CSyntheticLayout Layout(Config);
+	runStateBenchmarks(Results, Config, Layout);
+	runPerspectiveBenchmarks(Results, Config, Layout);
+	runPerspectiveDeltaBenchmark(Results, Config, Layout);
+	runBulkBenchmarks(Results, Config, Layout, false);
+	runBulkBenchmarks(Results, Config, Layout, true);
+	runTabSwitchBenchmark(Results, Config, Layout);
+	runResizeBenchmark(Results, Config, Layout);
+	runDragBenchmark(Results, Config, Layout);
+}
+
+//---------------------------------------------------------------------------
+// EOF LayoutBenchmarks.cpp
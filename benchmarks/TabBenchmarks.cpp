@@ -0,0 +1,55 @@
+//============================================================================
+/// \file   TabBenchmarks.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Measures the tab switch latency depending on the tab count
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "Benchmark.h"
+
+#include "DockManager.h"
+#include "DockAreaWidget.h"
+#include "DockAreaTitleBar.h"
+#include "DockAreaTabBar.h"
+
+using namespace ads;
+
+
+//============================================================================
+static void runTabCountBenchmark(CBenchmarkResults& Results,
+	const BenchmarkConfig& Config, int TabCount, bool Virtualized)
+{
+	BenchmarkConfig TabConfig = Config;
+	TabConfig.DockWidgets = TabCount;
+	TabConfig.DockAreas = 1;
+	TabConfig.FloatingContainers = 0;
+	CSyntheticLayout Layout(TabConfig);
+	auto DockArea = Layout.firstDockArea();
+	DockArea->titleBar()->tabBar()->setVirtualized(Virtualized);
+
+	// Cycle through the tabs like keyboard driven tab switching does
+	QJsonObject Parameters;
+	Parameters["tabs"] = TabCount;
+	Parameters["virtualized"] = Virtualized;
+	Results.measure("tab_switch_by_count", Config.Iterations * 10, [&](int i)
+	{
+		DockArea->setCurrentIndex((i + 1) % TabCount);
+	}, Parameters);
+}
+
+
+//============================================================================
+void runTabBenchmarks(CBenchmarkResults& Results, const BenchmarkConfig& Config)
+{
+	for (int TabCount : {10, 50, 200, 500})
+	{
+		runTabCountBenchmark(Results, Config, TabCount, false);
+		runTabCountBenchmark(Results, Config, TabCount, true);
+	}
+}
+
+//---------------------------------------------------------------------------
+// EOF TabBenchmarks.cpp
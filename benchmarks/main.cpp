@@ -0,0 +1,84 @@
+//============================================================================
+/// \file   main.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Entry point of the ads_benchmarks suite
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTextStream>
+
+#include "Benchmark.h"
+
+
+//============================================================================
+int main(int argc, char *argv[])
+{
+	// The benchmarks do not need a display
+	if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+	{
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	}
+	QApplication App(argc, argv);
+
+	BenchmarkConfig Config;
+	QCommandLineParser Parser;
+	Parser.setApplicationDescription("Qt Advanced Docking System benchmarks");
+	Parser.addHelpOption();
+	QCommandLineOption DockWidgetsOption("dock-widgets",
+		"Number of dock widgets.", "N", QString::number(Config.DockWidgets));
+	QCommandLineOption DockAreasOption("dock-areas",
+		"Number of docked dock areas.", "M", QString::number(Config.DockAreas));
+	QCommandLineOption FloatingOption("floating",
+		"Number of floating containers.", "K", QString::number(Config.FloatingContainers));
+	QCommandLineOption IterationsOption("iterations",
+		"Number of iterations per benchmark.", "count", QString::number(Config.Iterations));
+	QCommandLineOption OutputOption("output",
+		"Writes the JSON results to the given file instead of stdout.", "file");
+	Parser.addOptions({DockWidgetsOption, DockAreasOption, FloatingOption,
+		IterationsOption, OutputOption});
+	Parser.process(App);
+
+	Config.DockWidgets = qMax(1, Parser.value(DockWidgetsOption).toInt());
+	Config.DockAreas = qMax(1, Parser.value(DockAreasOption).toInt());
+	Config.FloatingContainers = qMax(0, Parser.value(FloatingOption).toInt());
+	Config.Iterations = qMax(1, Parser.value(IterationsOption).toInt());
+
+	CBenchmarkResults Results;
+	runLayoutBenchmarks(Results, Config);
+	runFocusBenchmarks(Results, Config);
+	runTabBenchmarks(Results, Config);
+
+	QJsonObject Report;
+	Report["qt_version"] = QString(qVersion());
+	Report["platform"] = QGuiApplication::platformName();
+	Report["config"] = Config.toJson();
+	Report["results"] = Results.toJson();
+	auto Json = QJsonDocument(Report).toJson();
+
+	if (Parser.isSet(OutputOption))
+	{
+		QFile File(Parser.value(OutputOption));
+		if (!File.open(QIODevice::WriteOnly))
+		{
+			qWarning() << "Cannot write" << File.fileName();
+			return 1;
+		}
+		File.write(Json);
+	}
+	else
+	{
+		QTextStream(stdout) << Json;
+	}
+	return 0;
+}
+
+//---------------------------------------------------------------------------
+// EOF main.cpp
@@ -567,7 +567,7 @@ void MainWindowPrivate::createContent()
 #endif
 #endif
 
-	for (auto DockWidget : DockManager->dockWidgetsMap())
+	for (auto DockWidget : DockManager->registeredDockWidgets())
 	{
 		_this->connect(DockWidget, SIGNAL(viewToggled(bool)), SLOT(onViewToggled(bool)));
 		_this->connect(DockWidget, SIGNAL(visibilityChanged(bool)), SLOT(onViewVisibilityChanged(bool)));
@@ -43,6 +43,8 @@
 #include "DockComponentsFactory.h"
 #include "AutoHideSideBar.h"
 #include "AutoHideTab.h"
+#include "DockingStateReader.h"
+#include "DockingStateWriter.h"
 
 
 #include <iostream>
@@ -118,6 +120,7 @@ struct AutoHideDockContainerPrivate
 	QSize Size; // creates invalid size
 	QPointer<CAutoHideTab> SideTab;
 	QSize SizeCache;
+	QPointer<CDockContainerWidget> EventRoutingContainer;
 
 	/**
 	 * Private data constructor
@@ -188,6 +191,28 @@ struct AutoHideDockContainerPrivate
 		}
 	}
 
+	/**
+	 * Enables or disables the routing of application events to this
+	 * auto hide widget via the event filter of its dock container
+	 */
+	void routeApplicationEvents(bool Enable)
+	{
+		if (EventRoutingContainer)
+		{
+			EventRoutingContainer->removeExpandedAutoHideWidget(_this);
+			EventRoutingContainer = nullptr;
+		}
+
+		if (Enable)
+		{
+			EventRoutingContainer = _this->dockContainer();
+			if (EventRoutingContainer)
+			{
+				EventRoutingContainer->registerExpandedAutoHideWidget(_this);
+			}
+		}
+	}
+
 }; // struct AutoHideDockContainerPrivate
 
 
@@ -303,8 +328,8 @@ CAutoHideDockContainer::~CAutoHideDockContainer()
 {
 	ADS_PRINT("~CAutoHideDockContainer");
 
-	// Remove event filter in case there are any queued messages
-	qApp->removeEventFilter(this);
+	// Stop the event routing in case there are any queued messages
+	d->routeApplicationEvents(false);
 	if (dockContainer())
 	{
 		dockContainer()->removeAutoHideWidget(this);
@@ -440,11 +465,19 @@ void CAutoHideDockContainer::cleanupAndDelete()
 //============================================================================
 void CAutoHideDockContainer::saveState(QXmlStreamWriter& s)
 {
-	s.writeStartElement("Widget");
-	s.writeAttribute("Name", d->DockWidget->objectName());
-	s.writeAttribute("Closed", QString::number(d->DockWidget->isClosed() ? 1 : 0));
-    s.writeAttribute("Size", QString::number(d->isHorizontal() ? d->Size.height() : d->Size.width()));
-	s.writeEndElement();
+	DockWidgetState State;
+	saveState(State);
+	CDockingStateWriter::writeDockWidget(s, State, true);
+}
+
+
+//============================================================================
+void CAutoHideDockContainer::saveState(DockWidgetState& State)
+{
+	State.Name = d->DockWidget->objectName();
+	State.Handle = d->DockWidget->handle();
+	State.Closed = d->DockWidget->isClosed();
+	State.Size = d->isHorizontal() ? d->Size.height() : d->Size.width();
 }
 
 
@@ -465,7 +498,7 @@ void CAutoHideDockContainer::toggleView(bool Enable)
             d->SideTab->hide();
         }
         hide();
-        qApp->removeEventFilter(this);
+        d->routeApplicationEvents(false);
 	}
 }
 
@@ -476,7 +509,7 @@ void CAutoHideDockContainer::collapseView(bool Enable)
 	if (Enable)
 	{
 		hide();
-		qApp->removeEventFilter(this);
+		d->routeApplicationEvents(false);
 	}
 	else
 	{
@@ -485,7 +518,7 @@ void CAutoHideDockContainer::collapseView(bool Enable)
 		raise();
 		show();
 		d->DockWidget->dockManager()->setDockWidgetFocused(d->DockWidget);
-		qApp->installEventFilter(this);
+		d->routeApplicationEvents(true);
 	}
 
 	ADS_PRINT("CAutoHideDockContainer::collapseView " << Enable);
@@ -512,6 +545,10 @@ void CAutoHideDockContainer::setSize(int Size)
 		d->Size.setWidth(Size);
 	}
 
+	if (dockContainer())
+	{
+		dockContainer()->markStateDirty();
+	}
 	updateSize();
 }
 
@@ -636,6 +673,10 @@ void CAutoHideDockContainer::resizeEvent(QResizeEvent* event)
 	{
         d->Size = this->size();
 		d->updateResizeHandleSizeLimitMax();
+		if (dockContainer())
+		{
+			dockContainer()->markStateDirty();
+		}
 	}
 }
 
@@ -46,6 +46,7 @@ class CAutoHideSideBar;
 class CDockAreaWidget;
 class CDockingStateReader;
 struct SideTabBarPrivate;
+struct DockWidgetState;
 
 /**
  * Auto hide container for hosting an auto hide dock widget
@@ -77,6 +78,11 @@ protected:
 	 */
 	void saveState(QXmlStreamWriter& Stream);
 
+	/*
+	 * Saves the state and size into the given state tree entry
+	 */
+	void saveState(DockWidgetState& State);
+
 public:
 	using Super = QFrame;
 
@@ -41,6 +41,7 @@
 #include "AutoHideDockContainer.h"
 #include "DockAreaWidget.h"
 #include "DockingStateReader.h"
+#include "DockingStateWriter.h"
 #include "AutoHideTab.h"
 
 namespace ads
@@ -196,6 +197,7 @@ void CAutoHideSideBar::insertTab(int Index, CAutoHideTab* SideTab)
 {
     SideTab->setSideBar(this);
 	SideTab->installEventFilter(this);
+	dockContainer()->markStateDirty();
 	// Default insertion is append
     if (Index < 0)
     {
@@ -270,6 +272,7 @@ void CAutoHideSideBar::addAutoHideWidget(CAutoHideDockContainer* AutoHideWidget,
 void CAutoHideSideBar::removeTab(CAutoHideTab* SideTab)
 {
 	SideTab->removeEventFilter(this);
+	dockContainer()->markStateDirty();
     d->TabsLayout->removeWidget(SideTab);
     if (d->TabsLayout->isEmpty())
     {
@@ -392,10 +395,17 @@ void CAutoHideSideBar::saveState(QXmlStreamWriter& s) const
 		return;
 	}
 
-	s.writeStartElement("SideBar");
-	s.writeAttribute("Area", QString::number(sideBarLocation()));
-	s.writeAttribute("Tabs", QString::number(count()));
+	SideBarState State;
+	saveState(State);
+	CDockingStateWriter::writeSideBar(s, State);
+}
+
 
+//============================================================================
+void CAutoHideSideBar::saveState(SideBarState& State) const
+{
+	State.Area = sideBarLocation();
+	State.DockWidgets.reserve(count());
 	for (auto i = 0; i < count(); ++i)
 	{
 		auto Tab = tab(i);
@@ -404,10 +414,10 @@ void CAutoHideSideBar::saveState(QXmlStreamWriter& s) const
 			continue;
 		}
 
-		Tab->dockWidget()->autoHideDockContainer()->saveState(s);
+		DockWidgetState DockWidget;
+		Tab->dockWidget()->autoHideDockContainer()->saveState(DockWidget);
+		State.DockWidgets.append(DockWidget);
 	}
-
-	s.writeEndElement();
 }
 
 //===========================================================================
@@ -0,0 +1,398 @@
+//============================================================================
+/// \file   CompressionDevice.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Implementation of CInflateDevice and CDeflateDevice classes
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "CompressionDevice.h"
+
+#include <QBuffer>
+
+#include <limits>
+
+#ifdef ADS_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ads
+{
+/**
+ * Size of the qCompress() header that stores the uncompressed size as
+ * 32 bit big endian value
+ */
+static const int SizeHeaderSize = 4;
+
+#ifdef ADS_HAS_ZLIB
+/**
+ * Size of the chunks that are read from the source or written to the
+ * target device
+ */
+static const int ChunkSize = 16 * 1024;
+#endif
+
+
+/**
+ * Private data class of CInflateDevice class (pimpl)
+ */
+struct InflateDevicePrivate
+{
+	QIODevice* Source;
+#ifdef ADS_HAS_ZLIB
+	z_stream Stream;
+	bool StreamInitialized = false;
+	bool Finished = false;
+	QByteArray Input;
+#else
+	QBuffer Buffer;
+#endif
+
+	InflateDevicePrivate(QIODevice* Source) : Source(Source) {}
+};
+
+
+//============================================================================
+CInflateDevice::CInflateDevice(QIODevice* Source)
+	: d(new InflateDevicePrivate(Source))
+{
+
+}
+
+
+//============================================================================
+CInflateDevice::~CInflateDevice()
+{
+	close();
+	delete d;
+}
+
+
+//============================================================================
+bool CInflateDevice::open(OpenMode Mode)
+{
+	if ((Mode & QIODevice::ReadWrite) != QIODevice::ReadOnly || !d->Source->isReadable())
+	{
+		setErrorString("Inflate device requires a readable source and read only mode");
+		return false;
+	}
+
+#ifdef ADS_HAS_ZLIB
+	if (d->Source->read(SizeHeaderSize).size() != SizeHeaderSize)
+	{
+		setErrorString("Compressed data is too short");
+		return false;
+	}
+
+	d->Stream = z_stream();
+	if (inflateInit(&d->Stream) != Z_OK)
+	{
+		setErrorString("Initializing zlib failed");
+		return false;
+	}
+	d->StreamInitialized = true;
+	d->Finished = false;
+#else
+	d->Buffer.setData(qUncompress(d->Source->readAll()));
+	if (d->Buffer.data().isEmpty())
+	{
+		setErrorString("Decompressing the data failed");
+		return false;
+	}
+	d->Buffer.open(QIODevice::ReadOnly);
+#endif
+	return QIODevice::open(Mode);
+}
+
+
+//============================================================================
+void CInflateDevice::close()
+{
+	if (!isOpen())
+	{
+		return;
+	}
+
+#ifdef ADS_HAS_ZLIB
+	if (d->StreamInitialized)
+	{
+		inflateEnd(&d->Stream);
+		d->StreamInitialized = false;
+	}
+	d->Input.clear();
+#else
+	d->Buffer.close();
+	d->Buffer.setData(QByteArray());
+#endif
+	QIODevice::close();
+}
+
+
+//============================================================================
+bool CInflateDevice::atEnd() const
+{
+#ifdef ADS_HAS_ZLIB
+	return !isOpen() || (d->Finished && QIODevice::bytesAvailable() == 0);
+#else
+	return !isOpen() || (d->Buffer.atEnd() && QIODevice::bytesAvailable() == 0);
+#endif
+}
+
+
+//============================================================================
+qint64 CInflateDevice::readData(char* Data, qint64 MaxSize)
+{
+#ifdef ADS_HAS_ZLIB
+	auto& Stream = d->Stream;
+	Stream.next_out = reinterpret_cast<Bytef*>(Data);
+	Stream.avail_out = uInt(qMin<qint64>(MaxSize, std::numeric_limits<uInt>::max()));
+	const auto OutputSize = Stream.avail_out;
+	while (Stream.avail_out > 0 && !d->Finished)
+	{
+		if (Stream.avail_in == 0)
+		{
+			d->Input = d->Source->read(ChunkSize);
+			if (d->Input.isEmpty())
+			{
+				// A source at its end before the end of the zlib stream
+				// means that the data is truncated
+				if (d->Source->atEnd())
+				{
+					setErrorString("Compressed data is truncated");
+					return (OutputSize == Stream.avail_out) ? -1 : qint64(OutputSize - Stream.avail_out);
+				}
+				break;
+			}
+			Stream.next_in = reinterpret_cast<Bytef*>(d->Input.data());
+			Stream.avail_in = uInt(d->Input.size());
+		}
+
+		int Result = inflate(&Stream, Z_NO_FLUSH);
+		if (Z_STREAM_END == Result)
+		{
+			d->Finished = true;
+		}
+		else if (Result != Z_OK && Result != Z_BUF_ERROR)
+		{
+			setErrorString("Decompressing the data failed");
+			return -1;
+		}
+	}
+	return qint64(OutputSize - Stream.avail_out);
+#else
+	return d->Buffer.read(Data, MaxSize);
+#endif
+}
+
+
+//============================================================================
+qint64 CInflateDevice::writeData(const char* Data, qint64 Size)
+{
+	Q_UNUSED(Data);
+	Q_UNUSED(Size);
+	return -1;
+}
+
+
+/**
+ * Private data class of CDeflateDevice class (pimpl)
+ */
+struct DeflateDevicePrivate
+{
+	QIODevice* Target;
+	int CompressionLevel;
+	bool Valid = true;
+	quint32 UncompressedSize = 0;
+#ifdef ADS_HAS_ZLIB
+	z_stream Stream;
+	qint64 HeaderPos = -1;
+	QByteArray Output;
+
+	/**
+	 * Runs deflate with the given flush mode and writes the compressed
+	 * output to the target device
+	 */
+	bool deflateInput(int Flush);
+#else
+	QByteArray Data;
+#endif
+
+	DeflateDevicePrivate(QIODevice* Target, int CompressionLevel)
+		: Target(Target), CompressionLevel(CompressionLevel) {}
+
+	/**
+	 * Writes the given data to the target device
+	 */
+	bool writeTarget(const char* Data, qint64 Size)
+	{
+		Valid = Valid && (Target->write(Data, Size) == Size);
+		return Valid;
+	}
+
+	/**
+	 * Returns the qCompress() header for the given size
+	 */
+	static QByteArray sizeHeader(quint32 Size)
+	{
+		QByteArray Header(SizeHeaderSize, 0);
+		Header[0] = char((Size >> 24) & 0xff);
+		Header[1] = char((Size >> 16) & 0xff);
+		Header[2] = char((Size >> 8) & 0xff);
+		Header[3] = char(Size & 0xff);
+		return Header;
+	}
+};
+
+
+#ifdef ADS_HAS_ZLIB
+//============================================================================
+bool DeflateDevicePrivate::deflateInput(int Flush)
+{
+	int Result;
+	do
+	{
+		Stream.next_out = reinterpret_cast<Bytef*>(Output.data());
+		Stream.avail_out = uInt(Output.size());
+		Result = deflate(&Stream, Flush);
+		if (Z_STREAM_ERROR == Result)
+		{
+			Valid = false;
+			return false;
+		}
+		if (!writeTarget(Output.constData(), Output.size() - Stream.avail_out))
+		{
+			return false;
+		}
+	} while (Stream.avail_out == 0 || (Z_FINISH == Flush && Result != Z_STREAM_END));
+	return true;
+}
+#endif
+
+
+//============================================================================
+CDeflateDevice::CDeflateDevice(QIODevice* Target, int CompressionLevel)
+	: d(new DeflateDevicePrivate(Target, CompressionLevel))
+{
+
+}
+
+
+//============================================================================
+CDeflateDevice::~CDeflateDevice()
+{
+	close();
+	delete d;
+}
+
+
+//============================================================================
+bool CDeflateDevice::open(OpenMode Mode)
+{
+	if ((Mode & QIODevice::ReadWrite) != QIODevice::WriteOnly || !d->Target->isWritable())
+	{
+		setErrorString("Deflate device requires a writable target and write only mode");
+		return false;
+	}
+
+	d->Valid = true;
+	d->UncompressedSize = 0;
+#ifdef ADS_HAS_ZLIB
+	d->Stream = z_stream();
+	if (deflateInit(&d->Stream, d->CompressionLevel) != Z_OK)
+	{
+		setErrorString("Initializing zlib failed");
+		return false;
+	}
+	d->Output.resize(ChunkSize);
+	d->HeaderPos = d->Target->isSequential() ? -1 : d->Target->pos();
+	d->writeTarget(DeflateDevicePrivate::sizeHeader(0).constData(), SizeHeaderSize);
+#else
+	d->Data.clear();
+#endif
+	return QIODevice::open(Mode);
+}
+
+
+//============================================================================
+void CDeflateDevice::close()
+{
+	if (!isOpen())
+	{
+		return;
+	}
+
+#ifdef ADS_HAS_ZLIB
+	d->Stream.next_in = nullptr;
+	d->Stream.avail_in = 0;
+	d->deflateInput(Z_FINISH);
+	deflateEnd(&d->Stream);
+	d->Output.clear();
+
+	// Patch the uncompressed size into the header to let qUncompress()
+	// allocate the right buffer size
+	if (d->Valid && d->HeaderPos >= 0)
+	{
+		auto EndPos = d->Target->pos();
+		d->Valid = d->Target->seek(d->HeaderPos)
+			&& d->writeTarget(DeflateDevicePrivate::sizeHeader(d->UncompressedSize).constData(), SizeHeaderSize)
+			&& d->Target->seek(EndPos);
+	}
+#else
+	auto Compressed = qCompress(d->Data, d->CompressionLevel);
+	d->Data.clear();
+	d->writeTarget(Compressed.constData(), Compressed.size());
+#endif
+	QIODevice::close();
+}
+
+
+//============================================================================
+bool CDeflateDevice::isValid() const
+{
+	return d->Valid;
+}
+
+
+//============================================================================
+qint64 CDeflateDevice::readData(char* Data, qint64 MaxSize)
+{
+	Q_UNUSED(Data);
+	Q_UNUSED(MaxSize);
+	return -1;
+}
+
+
+//============================================================================
+qint64 CDeflateDevice::writeData(const char* Data, qint64 Size)
+{
+	if (!d->Valid)
+	{
+		return -1;
+	}
+
+	d->UncompressedSize += quint32(Size);
+#ifdef ADS_HAS_ZLIB
+	// Feed the data in chunks that fit into the 32 bit zlib counters
+	auto Remaining = Size;
+	while (Remaining > 0)
+	{
+		auto Chunk = qMin<qint64>(Remaining, std::numeric_limits<uInt>::max());
+		d->Stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(Data + (Size - Remaining)));
+		d->Stream.avail_in = uInt(Chunk);
+		if (!d->deflateInput(Z_NO_FLUSH))
+		{
+			return -1;
+		}
+		Remaining -= Chunk;
+	}
+#else
+	d->Data.append(Data, int(Size));
+#endif
+	return Size;
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF CompressionDevice.cpp
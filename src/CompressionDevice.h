@@ -0,0 +1,107 @@
+#ifndef CompressionDeviceH
+#define CompressionDeviceH
+//============================================================================
+/// \file   CompressionDevice.h
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Declaration of CInflateDevice and CDeflateDevice classes
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QIODevice>
+
+namespace ads
+{
+struct InflateDevicePrivate;
+struct DeflateDevicePrivate;
+
+/**
+ * Sequential read only device that decompresses data in the qCompress()
+ * format while it is read from a source device.
+ * If the library has been built with zlib (ADS_HAS_ZLIB), the data is
+ * inflated in small chunks, so the compressed and the uncompressed data
+ * never need to be in memory completely. Without zlib, the source data is
+ * read completely and decompressed with qUncompress() when the device is
+ * opened.
+ */
+class CInflateDevice : public QIODevice
+{
+private:
+	InflateDevicePrivate* d; ///< private data (pimpl)
+
+protected:
+	virtual qint64 readData(char* Data, qint64 MaxSize) override;
+	virtual qint64 writeData(const char* Data, qint64 Size) override;
+
+public:
+	/**
+	 * Creates a device that reads from the given source device. The source
+	 * device needs to be open for reading.
+	 */
+	CInflateDevice(QIODevice* Source);
+
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~CInflateDevice();
+
+	virtual bool open(OpenMode Mode) override;
+	virtual void close() override;
+	virtual bool isSequential() const override {return true;}
+	virtual bool atEnd() const override;
+};
+
+
+/**
+ * Sequential write only device that compresses the written data into the
+ * qCompress() format and writes it to a target device.
+ * With zlib (ADS_HAS_ZLIB), the data is deflated while it is written. The
+ * uncompressed size in the qCompress() header is patched when the device is
+ * closed if the target device supports seeking. For sequential targets the
+ * size is stored as 0, which qUncompress() accepts as unknown size. Without
+ * zlib, the data is collected and compressed with qCompress() when the
+ * device is closed.
+ */
+class CDeflateDevice : public QIODevice
+{
+private:
+	DeflateDevicePrivate* d; ///< private data (pimpl)
+
+protected:
+	virtual qint64 readData(char* Data, qint64 MaxSize) override;
+	virtual qint64 writeData(const char* Data, qint64 Size) override;
+
+public:
+	/**
+	 * Creates a device that writes to the given target device with the
+	 * given compression level. The target device needs to be open for
+	 * writing.
+	 */
+	CDeflateDevice(QIODevice* Target, int CompressionLevel = 9);
+
+	/**
+	 * Virtual Destructor. Closes the device.
+	 */
+	virtual ~CDeflateDevice();
+
+	virtual bool open(OpenMode Mode) override;
+
+	/**
+	 * Finishes the compressed data and writes the remaining data to the
+	 * target device
+	 */
+	virtual void close() override;
+	virtual bool isSequential() const override {return true;}
+
+	/**
+	 * Returns true, if all data has been written to the target device
+	 * successfully
+	 */
+	bool isValid() const;
+};
+} // namespace ads
+
+//---------------------------------------------------------------------------
+#endif // CompressionDeviceH
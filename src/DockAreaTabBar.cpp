@@ -37,6 +37,10 @@
 #include <QApplication>
 #include <QtGlobal>
 #include <QTimer>
+#include <QSet>
+#include <QPointer>
+
+#include <algorithm>
 
 #include "FloatingDockContainer.h"
 #include "DockAreaWidget.h"
@@ -59,7 +63,17 @@ struct DockAreaTabBarPrivate
 	CDockAreaWidget* DockArea;
 	QWidget* TabsContainerWidget;
 	QBoxLayout* TabsLayout;
+	QVector<CDockWidgetTab*> Tabs;
 	int CurrentIndex = -1;
+	bool Virtualized = false;
+	QVector<int> TabWidths;
+	QVector<int> TabOffsets;
+	QVector<CDockWidgetTab*> LiveTabs;
+	bool TabOffsetsDirty = true;
+	int TabHeight = 0;
+	QSet<CDockWidgetTab*> ElidedTabs;
+	QPointer<CDockWidgetTab> ActiveTab;
+	bool EnsureCurrentTabVisiblePending = false;
 
 	/**
 	 * Private data constructor
@@ -67,11 +81,80 @@ struct DockAreaTabBarPrivate
 	DockAreaTabBarPrivate(CDockAreaTabBar* _public);
 
 	/**
-	 * Update tabs after current index changed or when tabs are removed.
+	 * Updates the set of open tabs with an elided title for the given tab
+	 */
+	void updateElidedTab(CDockWidgetTab* Tab)
+	{
+		if (!Tab->isHidden() && Tab->isTitleElided())
+		{
+			ElidedTabs.insert(Tab);
+		}
+		else
+		{
+			ElidedTabs.remove(Tab);
+		}
+	}
+
+	/**
+	 * Switches the virtualized mode on or off depending on the tab bar
+	 * virtualization threshold of the dock manager
+	 */
+	void updateVirtualization();
+
+	/**
+	 * Invalidates the cached width of the tab with the given index.
+	 * Pass -1 to invalidate only the tab offsets.
+	 */
+	void invalidateTabWidth(int Index);
+
+	/**
+	 * Recalculates the offsets of all tabs from the cached tab widths.
+	 * Closed tabs have no width.
+	 */
+	void updateTabOffsets();
+
+	/**
+	 * Positions the tabs in or near the visible part of the tab bar and
+	 * parks all other tabs outside of the tabs container widget
+	 */
+	void layoutVirtualTabs();
+
+	/**
+	 * Moves the given tab outside of the tabs container so that it is
+	 * never painted
+	 */
+	void parkTab(CDockWidgetTab* Tab);
+
+	/**
+	 * Returns the index of the tab at the given x position in tabs
+	 * container coordinates. Returns -1 if the position is left of the
+	 * first tab and count() if the position is right of the last tab.
+	 */
+	int virtualTabIndexAt(int X);
+
+	/**
+	 * Scrolls the tab bar to make the tab with the given index visible
+	 */
+	void ensureTabVisible(int Index);
+
+	/**
+	 * Update all tabs after tabs are removed or the layout mode changed.
 	 * The function reassigns the stylesheet to update the tabs
 	 */
 	void updateTabs();
 
+	/**
+	 * Updates the previously active and the current tab after the current
+	 * index changed
+	 */
+	void activateCurrentTab();
+
+	/**
+	 * Scrolls the current tab into view from the event loop. Multiple
+	 * requests are coalesced into one deferred call.
+	 */
+	void ensureCurrentTabVisible();
+
 	/**
 	 * Convenience function to access first tab
 	 */
@@ -95,6 +178,7 @@ DockAreaTabBarPrivate::DockAreaTabBarPrivate(CDockAreaTabBar* _public) :
 //============================================================================
 void DockAreaTabBarPrivate::updateTabs()
 {
+	ActiveTab = nullptr;
 	// Set active TAB and update all other tabs to be inactive
 	for (int i = 0; i < _this->count(); ++i)
 	{
@@ -108,13 +192,8 @@ void DockAreaTabBarPrivate::updateTabs()
 		{
 			TabWidget->show();
 			TabWidget->setActiveTab(true);
-			// Sometimes the synchronous calculation of the rectangular area fails
-			// Therefore we use QTimer::singleShot here to execute the call
-			// within the event loop - see #520
-			QTimer::singleShot(0, _this, [&, TabWidget]
-			{
-				_this->ensureWidgetVisible(TabWidget);
-			});
+			ActiveTab = TabWidget;
+			ensureCurrentTabVisible();
 		}
 		else
 		{
@@ -124,6 +203,203 @@ void DockAreaTabBarPrivate::updateTabs()
 }
 
 
+//============================================================================
+void DockAreaTabBarPrivate::activateCurrentTab()
+{
+	auto TabWidget = _this->tab(CurrentIndex);
+	if (ActiveTab && ActiveTab != TabWidget)
+	{
+		ActiveTab->setActiveTab(false);
+	}
+
+	ActiveTab = TabWidget;
+	if (TabWidget)
+	{
+		TabWidget->show();
+		TabWidget->setActiveTab(true);
+		ensureCurrentTabVisible();
+	}
+}
+
+
+//============================================================================
+void DockAreaTabBarPrivate::ensureCurrentTabVisible()
+{
+	if (EnsureCurrentTabVisiblePending)
+	{
+		return;
+	}
+
+	// Sometimes the synchronous calculation of the rectangular area fails
+	// Therefore we use QTimer::singleShot here to execute the call
+	// within the event loop - see #520
+	EnsureCurrentTabVisiblePending = true;
+	QTimer::singleShot(0, _this, [this]
+	{
+		EnsureCurrentTabVisiblePending = false;
+		auto TabWidget = _this->currentTab();
+		if (!TabWidget)
+		{
+			return;
+		}
+
+		if (Virtualized)
+		{
+			ensureTabVisible(CurrentIndex);
+		}
+		else
+		{
+			_this->ensureWidgetVisible(TabWidget);
+		}
+	});
+}
+
+
+//============================================================================
+void DockAreaTabBarPrivate::updateVirtualization()
+{
+	auto DockManager = DockArea->dockManager();
+	int Threshold = DockManager ? DockManager->tabBarVirtualizationThreshold() : 0;
+	if (Threshold > 0)
+	{
+		_this->setVirtualized(Tabs.count() >= Threshold);
+	}
+}
+
+
+//============================================================================
+void DockAreaTabBarPrivate::invalidateTabWidth(int Index)
+{
+	if (!Virtualized)
+	{
+		return;
+	}
+
+	if (Index >= 0 && Index < TabWidths.count())
+	{
+		TabWidths[Index] = -1;
+	}
+	TabOffsetsDirty = true;
+	layoutVirtualTabs();
+	_this->updateGeometry();
+}
+
+
+//============================================================================
+void DockAreaTabBarPrivate::updateTabOffsets()
+{
+	if (!TabOffsetsDirty)
+	{
+		return;
+	}
+
+	TabOffsets.resize(Tabs.count() + 1);
+	TabOffsets[0] = 0;
+	for (int i = 0; i < Tabs.count(); ++i)
+	{
+		auto Tab = Tabs[i];
+		if (TabWidths[i] < 0)
+		{
+			auto SizeHint = Tab->sizeHint();
+			TabWidths[i] = SizeHint.width();
+			TabHeight = qMax(TabHeight, SizeHint.height());
+		}
+		TabOffsets[i + 1] = TabOffsets[i] + (Tab->isHidden() ? 0 : TabWidths[i]);
+	}
+	TabsContainerWidget->setMinimumSize(TabOffsets.last(), TabHeight);
+	TabOffsetsDirty = false;
+}
+
+
+//============================================================================
+void DockAreaTabBarPrivate::parkTab(CDockWidgetTab* Tab)
+{
+	Tab->move(-Tab->width() - 1, 0);
+}
+
+
+//============================================================================
+void DockAreaTabBarPrivate::layoutVirtualTabs()
+{
+	updateTabOffsets();
+
+	// We keep half a viewport of tabs alive on each side to make scrolling
+	// and tab dragging smooth
+	int ViewportWidth = _this->viewport()->width();
+	int Left = _this->horizontalScrollBar()->value() - ViewportWidth / 2;
+	int Right = Left + 2 * ViewportWidth;
+	int First = int(std::upper_bound(TabOffsets.begin() + 1, TabOffsets.end(), Left)
+		- TabOffsets.begin()) - 1;
+	int Height = qMax(TabHeight, TabsContainerWidget->height());
+
+	QVector<CDockWidgetTab*> Live;
+	for (int i = First; i < Tabs.count() && TabOffsets[i] < Right; ++i)
+	{
+		auto Tab = Tabs[i];
+		if (Tab->isHidden())
+		{
+			continue;
+		}
+
+		Live.append(Tab);
+		if (Tab->dragState() != DraggingTab)
+		{
+			Tab->setGeometry(TabOffsets[i], 0, TabWidths[i], Height);
+		}
+	}
+
+	for (auto Tab : LiveTabs)
+	{
+		if (!Live.contains(Tab) && Tabs.contains(Tab))
+		{
+			parkTab(Tab);
+		}
+	}
+	LiveTabs = Live;
+}
+
+
+//============================================================================
+int DockAreaTabBarPrivate::virtualTabIndexAt(int X)
+{
+	updateTabOffsets();
+	if (X < 0)
+	{
+		return -1;
+	}
+
+	if (X >= TabOffsets.last())
+	{
+		return Tabs.count();
+	}
+
+	return int(std::upper_bound(TabOffsets.begin() + 1, TabOffsets.end(), X)
+		- TabOffsets.begin()) - 1;
+}
+
+
+//============================================================================
+void DockAreaTabBarPrivate::ensureTabVisible(int Index)
+{
+	if (Index < 0 || Index >= Tabs.count())
+	{
+		return;
+	}
+
+	updateTabOffsets();
+	auto ScrollBar = _this->horizontalScrollBar();
+	int ViewportWidth = _this->viewport()->width();
+	if (TabOffsets[Index] < ScrollBar->value())
+	{
+		ScrollBar->setValue(TabOffsets[Index]);
+	}
+	else if (TabOffsets[Index + 1] > ScrollBar->value() + ViewportWidth)
+	{
+		ScrollBar->setValue(TabOffsets[Index + 1] - ViewportWidth);
+	}
+}
+
+
 //============================================================================
 CDockAreaTabBar::CDockAreaTabBar(CDockAreaWidget* parent) :
 	QScrollArea(parent),
@@ -144,7 +420,15 @@ CDockAreaTabBar::CDockAreaTabBar(CDockAreaWidget* parent) :
 	d->TabsLayout->setSpacing(0);
 	d->TabsLayout->addStretch(1);
 	d->TabsContainerWidget->setLayout(d->TabsLayout);
+	d->TabsContainerWidget->installEventFilter(this);
 	setWidget(d->TabsContainerWidget);
+	connect(horizontalScrollBar(), &QScrollBar::valueChanged, this, [this]()
+	{
+		if (d->Virtualized)
+		{
+			d->layoutVirtualTabs();
+		}
+	});
 
     setFocusPolicy(Qt::NoFocus);
 }
@@ -163,6 +447,61 @@ void CDockAreaTabBar::wheelEvent(QWheelEvent* Event)
     QCoreApplication::sendEvent(horizontalScrollBar(), Event);
 }
 
+
+//============================================================================
+void CDockAreaTabBar::resizeEvent(QResizeEvent* Event)
+{
+	Super::resizeEvent(Event);
+	if (d->Virtualized)
+	{
+		d->layoutVirtualTabs();
+	}
+}
+
+
+//============================================================================
+void CDockAreaTabBar::setVirtualized(bool Virtualized)
+{
+	if (Virtualized == d->Virtualized)
+	{
+		return;
+	}
+
+	d->Virtualized = Virtualized;
+	if (Virtualized)
+	{
+		for (auto Tab : d->Tabs)
+		{
+			d->TabsLayout->removeWidget(Tab);
+			d->parkTab(Tab);
+		}
+		d->TabWidths.fill(-1, d->Tabs.count());
+		d->TabOffsetsDirty = true;
+		d->layoutVirtualTabs();
+	}
+	else
+	{
+		d->TabsContainerWidget->setMinimumSize(0, 0);
+		for (int i = 0; i < d->Tabs.count(); ++i)
+		{
+			d->TabsLayout->insertWidget(i, d->Tabs[i]);
+		}
+		d->TabWidths.clear();
+		d->TabOffsets.clear();
+		d->LiveTabs.clear();
+	}
+
+	updateGeometry();
+	d->updateTabs();
+}
+
+
+//============================================================================
+bool CDockAreaTabBar::isVirtualized() const
+{
+	return d->Virtualized;
+}
+
 //============================================================================
 void CDockAreaTabBar::setCurrentIndex(int index)
 {
@@ -179,7 +518,7 @@ void CDockAreaTabBar::setCurrentIndex(int index)
 
     Q_EMIT currentChanging(index);
 	d->CurrentIndex = index;
-	d->updateTabs();
+	d->activateCurrentTab();
 	updateGeometry();
 	Q_EMIT currentChanged(index);
 }
@@ -188,21 +527,46 @@ void CDockAreaTabBar::setCurrentIndex(int index)
 //============================================================================
 int CDockAreaTabBar::count() const
 {
-	// The tab bar contains a stretch item as last item
-	return d->TabsLayout->count() - 1;
+	return d->Tabs.count();
 }
 
 
 //===========================================================================
 void CDockAreaTabBar::insertTab(int Index, CDockWidgetTab* Tab)
 {
-	d->TabsLayout->insertWidget(Index, Tab);
+	if (Index < 0 || Index > count())
+	{
+		Index = count();
+	}
+	d->Tabs.insert(Index, Tab);
+	if (d->Virtualized)
+	{
+		// Like QLayout::addChildWidget() we need to show the reparented
+		// tab again, if it has not been hidden explicitly
+		bool NeedShow = !(Tab->isHidden() && Tab->testAttribute(Qt::WA_WState_ExplicitShowHide));
+		if (Tab->parentWidget() != d->TabsContainerWidget)
+		{
+			Tab->setParent(d->TabsContainerWidget);
+		}
+		d->parkTab(Tab);
+		if (NeedShow)
+		{
+			Tab->show();
+		}
+		d->TabWidths.insert(Index, -1);
+		d->invalidateTabWidth(-1);
+	}
+	else
+	{
+		d->TabsLayout->insertWidget(Index, Tab);
+	}
 	connect(Tab, SIGNAL(clicked()), this, SLOT(onTabClicked()));
 	connect(Tab, SIGNAL(closeRequested()), this, SLOT(onTabCloseRequested()));
 	connect(Tab, SIGNAL(closeOtherTabsRequested()), this, SLOT(onCloseOtherTabsRequested()));
 	connect(Tab, SIGNAL(moved(QPoint)), this, SLOT(onTabWidgetMoved(QPoint)));
-	connect(Tab, SIGNAL(elidedChanged(bool)), this, SIGNAL(elidedChanged(bool)));
+	connect(Tab, SIGNAL(elidedChanged(bool)), this, SLOT(onTabElidedChanged(bool)));
 	Tab->installEventFilter(this);
+	d->updateElidedTab(Tab);
 	Q_EMIT tabInserted(Index);
     if (Index <= d->CurrentIndex)
 	{
@@ -213,7 +577,14 @@ void CDockAreaTabBar::insertTab(int Index, CDockWidgetTab* Tab)
     	setCurrentIndex(Index);
     }
 
+	// The tab may still be active from a previous dock area
+	if (Tab != d->ActiveTab)
+	{
+		Tab->setActiveTab(false);
+	}
+
 	updateGeometry();
+	d->updateVirtualization();
 }
 
 
@@ -226,7 +597,11 @@ void CDockAreaTabBar::removeTab(CDockWidgetTab* Tab)
 	}
     ADS_PRINT("CDockAreaTabBar::removeTab ");
 	int NewCurrentIndex = currentIndex();
-	int RemoveIndex = d->TabsLayout->indexOf(Tab);
+	int RemoveIndex = d->Tabs.indexOf(Tab);
+	if (RemoveIndex < 0)
+	{
+		return;
+	}
 	if (count() == 1)
 	{
 		NewCurrentIndex = -1;
@@ -264,7 +639,22 @@ void CDockAreaTabBar::removeTab(CDockWidgetTab* Tab)
 	}
 
 	Q_EMIT removingTab(RemoveIndex);
-	d->TabsLayout->removeWidget(Tab);
+	d->Tabs.removeAt(RemoveIndex);
+	d->ElidedTabs.remove(Tab);
+	if (Tab == d->ActiveTab)
+	{
+		d->ActiveTab = nullptr;
+	}
+	if (d->Virtualized)
+	{
+		d->TabWidths.removeAt(RemoveIndex);
+		d->LiveTabs.removeOne(Tab);
+		d->invalidateTabWidth(-1);
+	}
+	else
+	{
+		d->TabsLayout->removeWidget(Tab);
+	}
 	Tab->disconnect(this);
 	Tab->removeEventFilter(this);
     ADS_PRINT("NewCurrentIndex " << NewCurrentIndex);
@@ -278,6 +668,7 @@ void CDockAreaTabBar::removeTab(CDockWidgetTab* Tab)
 	}
 
 	updateGeometry();
+	d->updateVirtualization();
 }
 
 
@@ -291,14 +682,7 @@ int CDockAreaTabBar::currentIndex() const
 //===========================================================================
 CDockWidgetTab* CDockAreaTabBar::currentTab() const
 {
-	if (d->CurrentIndex < 0 || d->CurrentIndex >= d->TabsLayout->count())
-	{
-		return nullptr;
-	}
-	else
-	{
-		return qobject_cast<CDockWidgetTab*>(d->TabsLayout->itemAt(d->CurrentIndex)->widget());
-	}
+	return tab(d->CurrentIndex);
 }
 
 
@@ -311,7 +695,7 @@ void CDockAreaTabBar::onTabClicked()
 		return;
 	}
 
-	int index = d->TabsLayout->indexOf(Tab);
+	int index = d->Tabs.indexOf(Tab);
 	if (index < 0)
 	{
 		return;
@@ -321,11 +705,30 @@ void CDockAreaTabBar::onTabClicked()
 }
 
 
+//===========================================================================
+void CDockAreaTabBar::onTabElidedChanged(bool Elided)
+{
+	auto Tab = qobject_cast<CDockWidgetTab*>(sender());
+	if (Tab)
+	{
+		d->updateElidedTab(Tab);
+	}
+	Q_EMIT elidedChanged(Elided);
+}
+
+
+//===========================================================================
+int CDockAreaTabBar::elidedTabCount() const
+{
+	return d->ElidedTabs.count();
+}
+
+
 //===========================================================================
 void CDockAreaTabBar::onTabCloseRequested()
 {
 	CDockWidgetTab* Tab = qobject_cast<CDockWidgetTab*>(sender());
-	int Index = d->TabsLayout->indexOf(Tab);
+	int Index = d->Tabs.indexOf(Tab);
 	closeTab(Index);
 }
 
@@ -351,7 +754,7 @@ CDockWidgetTab* CDockAreaTabBar::tab(int Index) const
 	{
 		return nullptr;
 	}
-	return qobject_cast<CDockWidgetTab*>(d->TabsLayout->itemAt(Index)->widget());
+	return d->Tabs[Index];
 }
 
 
@@ -364,13 +767,21 @@ void CDockAreaTabBar::onTabWidgetMoved(const QPoint& GlobalPos)
 		return;
 	}
 
-	int fromIndex = d->TabsLayout->indexOf(MovingTab);
+	int fromIndex = d->Tabs.indexOf(MovingTab);
 	auto MousePos = mapFromGlobal(GlobalPos);
 	MousePos.rx() = qMax(0, MousePos.x());
 	MousePos.rx() = qMin(width(), MousePos.x());
 	int toIndex = -1;
+	if (d->Virtualized)
+	{
+		toIndex = d->virtualTabIndexAt(d->TabsContainerWidget->mapFrom(this, MousePos).x());
+		if (toIndex < 0 || toIndex >= count() || toIndex == fromIndex)
+		{
+			toIndex = -1;
+		}
+	}
 	// Find tab under mouse
-	for (int i = 0; i < count(); ++i)
+	for (int i = 0; !d->Virtualized && i < count(); ++i)
 	{
 		CDockWidgetTab* DropTab = tab(i);
 		auto TabGeometry = DropTab->geometry();
@@ -382,7 +793,7 @@ void CDockAreaTabBar::onTabWidgetMoved(const QPoint& GlobalPos)
 			continue;
 		}
 
-		toIndex = d->TabsLayout->indexOf(DropTab);
+		toIndex = i;
 		if (toIndex == fromIndex)
 		{
 			toIndex = -1;
@@ -392,8 +803,17 @@ void CDockAreaTabBar::onTabWidgetMoved(const QPoint& GlobalPos)
 
 	if (toIndex > -1)
 	{
-		d->TabsLayout->removeWidget(MovingTab);
-		d->TabsLayout->insertWidget(toIndex, MovingTab);
+		d->Tabs.move(fromIndex, toIndex);
+		if (d->Virtualized)
+		{
+			d->TabWidths.move(fromIndex, toIndex);
+			d->invalidateTabWidth(-1);
+		}
+		else
+		{
+			d->TabsLayout->removeWidget(MovingTab);
+			d->TabsLayout->insertWidget(toIndex, MovingTab);
+		}
         ADS_PRINT("tabMoved from " << fromIndex << " to " << toIndex);
 		Q_EMIT tabMoved(fromIndex, toIndex);
 		setCurrentIndex(toIndex);
@@ -426,6 +846,17 @@ void CDockAreaTabBar::closeTab(int Index)
 bool CDockAreaTabBar::eventFilter(QObject *watched, QEvent *event)
 {
 	bool Result = Super::eventFilter(watched, event);
+	if (watched == d->TabsContainerWidget)
+	{
+		// A dragged tab requests a layout update of the tabs container
+		// to reset its position if the drag ends
+		if (d->Virtualized && event->type() == QEvent::LayoutRequest)
+		{
+			d->layoutVirtualTabs();
+		}
+		return Result;
+	}
+
 	CDockWidgetTab* Tab = qobject_cast<CDockWidgetTab*>(watched);
 	if (!Tab)
 	{
@@ -434,18 +865,28 @@ bool CDockAreaTabBar::eventFilter(QObject *watched, QEvent *event)
 
 	switch (event->type())
 	{
+	// In contrast to Show and Hide events, these events are also sent if
+	// the tab bar itself is hidden
+	case QEvent::ShowToParent:
+	case QEvent::HideToParent:
+		 d->updateElidedTab(Tab);
+		 break;
+
 	case QEvent::Hide:
-		 Q_EMIT tabClosed(d->TabsLayout->indexOf(Tab));
+		 Q_EMIT tabClosed(d->Tabs.indexOf(Tab));
+		 d->invalidateTabWidth(-1);
 		 updateGeometry();
 		 break;
 
 	case QEvent::Show:
-		 Q_EMIT tabOpened(d->TabsLayout->indexOf(Tab));
+		 Q_EMIT tabOpened(d->Tabs.indexOf(Tab));
+		 d->invalidateTabWidth(-1);
 		 updateGeometry();
 		 break;
 
     // Setting the text of a tab will cause a LayoutRequest event
     case QEvent::LayoutRequest:
+         d->invalidateTabWidth(d->Tabs.indexOf(Tab));
          updateGeometry();
          break;
 
@@ -490,6 +931,11 @@ QSize CDockAreaTabBar::minimumSizeHint() const
 //===========================================================================
 QSize CDockAreaTabBar::sizeHint() const
 {
+	if (d->Virtualized)
+	{
+		d->updateTabOffsets();
+		return QSize(d->TabOffsets.last(), d->TabHeight);
+	}
 	return d->TabsContainerWidget->sizeHint();
 }
 
@@ -502,6 +948,11 @@ int CDockAreaTabBar::tabAt(const QPoint& Pos) const
 		return TabInvalidIndex;
 	}
 
+	if (d->Virtualized)
+	{
+		return d->virtualTabIndexAt(d->TabsContainerWidget->mapFrom(this, Pos).x());
+	}
+
 	if (Pos.x() < tab(0)->geometry().x())
 	{
 		return -1;
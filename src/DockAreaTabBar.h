@@ -63,9 +63,11 @@ private Q_SLOTS:
 	void onTabCloseRequested();
 	void onCloseOtherTabsRequested();
 	void onTabWidgetMoved(const QPoint& GlobalPos);
+	void onTabElidedChanged(bool Elided);
 
 protected:
     virtual void wheelEvent(QWheelEvent* Event) override;
+    virtual void resizeEvent(QResizeEvent* Event) override;
 
 public:
 	using Super = QScrollArea;
@@ -158,6 +160,32 @@ public:
 	 */
 	bool areTabsOverflowing() const;
 
+	/**
+	 * Returns the number of open tabs with an elided title.
+	 * The count is updated incrementally if tabs are elided, opened, closed,
+	 * inserted or removed.
+	 */
+	int elidedTabCount() const;
+
+	/**
+	 * Enables or disables the virtualized mode.
+	 * In virtualized mode the tabs are not managed by a layout. The tab bar
+	 * only keeps the preferred width of each tab and positions the tabs in
+	 * or near the visible part of the tab bar. All other tabs are parked
+	 * outside of the visible area. This makes inserting and removing of
+	 * tabs and resizing of tab bars with hundreds of tabs cheap. Tabs are
+	 * not elided in virtualized mode - the tab bar scrolls instead.
+	 * If the dock manager has a tab bar virtualization threshold, the mode
+	 * is switched automatically if tabs are inserted or removed.
+	 * \see CDockManager::setTabBarVirtualizationThreshold()
+	 */
+	void setVirtualized(bool Virtualized);
+
+	/**
+	 * Returns true, if the tab bar is in virtualized mode
+	 */
+	bool isVirtualized() const;
+
 public Q_SLOTS:
 	/**
 	 * This property sets the index of the tab bar's visible tab
@@ -35,6 +35,10 @@
 #include <QStyle>
 #include <QMenu>
 #include <QScrollArea>
+#include <QLineEdit>
+#include <QWidgetAction>
+#include <QKeyEvent>
+#include <QTimer>
 #include <QMouseEvent>
 #include <QDebug>
 #include <QPointer>
@@ -76,8 +80,9 @@ struct DockAreaTitleBarPrivate
 	CDockAreaWidget* DockArea;
 	CDockAreaTabBar* TabBar;
 	CElidingLabel* AutoHideTitleLabel = nullptr;
-	bool MenuOutdated = true;
-	QMenu* TabsMenu;
+	CDockAreaTabsMenu* TabsMenu = nullptr;
+	bool TabsMenuButtonVisible = false;
+	bool TabsMenuButtonUpdatePending = false;
 	QList<tTitleBarButton*> DockWidgetActionsButtons;
 
 	QPoint DragStartMousePos;
@@ -95,6 +100,14 @@ struct DockAreaTitleBarPrivate
 	 */
 	void createButtons();
 
+	/**
+	 * Sets the visibility of the tabs menu button from the event loop to
+	 * ensure that the relayouting has finished. Multiple requests are
+	 * coalesced into one update and requests that would not change the
+	 * visibility are dropped.
+	 */
+	void updateTabsMenuButtonVisibility(bool Visible);
+
 
 	/**
 	 * Creates the auto hide title label, only displayed when the dock area is overlayed
@@ -180,6 +193,27 @@ DockAreaTitleBarPrivate::DockAreaTitleBarPrivate(CDockAreaTitleBar* _public) :
 }
 
 
+//============================================================================
+void DockAreaTitleBarPrivate::updateTabsMenuButtonVisibility(bool Visible)
+{
+	TabsMenuButtonVisible = Visible;
+	if (TabsMenuButtonUpdatePending || TabsMenuButton->isHidden() != Visible)
+	{
+		return;
+	}
+
+	TabsMenuButtonUpdatePending = true;
+	QTimer::singleShot(0, _this, [this]()
+	{
+		TabsMenuButtonUpdatePending = false;
+		if (TabsMenuButton)
+		{
+			TabsMenuButton->setVisible(TabsMenuButtonVisible);
+		}
+	});
+}
+
+
 //============================================================================
 void DockAreaTitleBarPrivate::createButtons()
 {
@@ -192,12 +226,11 @@ void DockAreaTitleBarPrivate::createButtons()
 	TabsMenuButton->setAutoRaise(true);
 	TabsMenuButton->setPopupMode(QToolButton::InstantPopup);
 	internal::setButtonIcon(TabsMenuButton, QStyle::SP_TitleBarUnshadeButton, ads::DockAreaMenuIcon);
-    QMenu* TabsMenu = new QMenu(TabsMenuButton);
+    TabsMenu = new CDockAreaTabsMenu(TabBar, TabsMenuButton);
     TabsMenu->setObjectName("tabsMenu");
 #ifndef QT_NO_TOOLTIP
 	TabsMenu->setToolTipsVisible(true);
 #endif
-	_this->connect(TabsMenu, SIGNAL(aboutToShow()), SLOT(onTabsMenuAboutToShow()));
 	TabsMenuButton->setMenu(TabsMenu);
 	internal::setToolTip(TabsMenuButton, QObject::tr("List All Tabs"));
 	TabsMenuButton->setSizePolicy(ButtonSizePolicy);
@@ -405,6 +438,17 @@ void CDockAreaTitleBar::resizeEvent(QResizeEvent *event)
 //============================================================================
 void CDockAreaTitleBar::markTabsMenuOutdated()
 {
+	if (d->TabsMenu)
+	{
+		d->TabsMenu->markOutdated();
+	}
+	// The tabs menu button visibility is updated in CDockManager::endLayoutUpdate()
+	auto DockManager = d->DockArea->dockManager();
+	if (DockManager && DockManager->isLayoutUpdateActive())
+	{
+		return;
+	}
+
 	if (CDockManager::testConfigFlag(CDockManager::DockAreaDynamicTabsMenuButtonVisibility))
 	{
 		bool TabsMenuButtonVisible = false;
@@ -414,53 +458,12 @@ void CDockAreaTitleBar::markTabsMenuOutdated()
 		}
 		else
 		{
-			bool hasElidedTabTitle = false;
-			for (int i = 0; i < d->TabBar->count(); ++i)
-			{
-				if (!d->TabBar->isTabOpen(i))
-				{
-					continue;
-				}
-				CDockWidgetTab* Tab = d->TabBar->tab(i);
-				if(Tab->isTitleElided())
-				{
-					hasElidedTabTitle = true;
-					break;
-				}
-			}
-			TabsMenuButtonVisible = (hasElidedTabTitle && (d->TabBar->count() > 1));
-		}
-		QMetaObject::invokeMethod(d->TabsMenuButton, "setVisible", Qt::QueuedConnection, Q_ARG(bool, TabsMenuButtonVisible));
-	}
-	d->MenuOutdated = true;
-}
-
-//============================================================================
-void CDockAreaTitleBar::onTabsMenuAboutToShow()
-{
-	if (!d->MenuOutdated)
-	{
-		return;
-	}
-
-	QMenu* menu = d->TabsMenuButton->menu();
-	menu->clear();
-	for (int i = 0; i < d->TabBar->count(); ++i)
-	{
-		if (!d->TabBar->isTabOpen(i))
-		{
-			continue;
+			TabsMenuButtonVisible = (d->TabBar->elidedTabCount() > 0) && (d->TabBar->count() > 1);
 		}
-		auto Tab = d->TabBar->tab(i);
-		QAction* Action = menu->addAction(Tab->icon(), Tab->text());
-		internal::setToolTip(Action, Tab->toolTip());
-		Action->setData(i);
+		d->updateTabsMenuButtonVisibility(TabsMenuButtonVisible);
 	}
-
-	d->MenuOutdated = false;
 }
 
-
 //============================================================================
 void CDockAreaTitleBar::onCloseButtonClicked()
 {
@@ -698,7 +701,7 @@ void CDockAreaTitleBar::mouseMoveEvent(QMouseEvent* ev)
 	// sense to move it to a new floating widget and leave this one
 	// empty
 	if (d->DockArea->dockContainer()->isFloating()
-	 && d->DockArea->dockContainer()->visibleDockAreaCount() == 1 
+	 && d->DockArea->dockContainer()->layoutStatistics().VisibleDockAreas == 1
      && !d->DockArea->isAutoHide())
 	{
 		return;
@@ -1010,6 +1013,158 @@ CSpacerWidget::CSpacerWidget(QWidget* Parent /*= 0*/) : Super(Parent)
 }
 
 
+//============================================================================
+CDockAreaTabsMenu::CDockAreaTabsMenu(CDockAreaTabBar* TabBar, QWidget* Parent) :
+	Super(Parent),
+	TabBar(TabBar)
+{
+	FilterEdit = new QLineEdit(this);
+	FilterEdit->setObjectName("tabsMenuFilterEdit");
+	FilterEdit->setPlaceholderText(tr("Filter"));
+	FilterEdit->setClearButtonEnabled(true);
+	FilterAction = new QWidgetAction(this);
+	FilterAction->setDefaultWidget(FilterEdit);
+	FilterAction->setVisible(false);
+	addAction(FilterAction);
+
+	connect(this, SIGNAL(aboutToShow()), SLOT(onAboutToShow()));
+	connect(this, SIGNAL(aboutToHide()), SLOT(onAboutToHide()));
+	connect(FilterEdit, SIGNAL(textChanged(QString)), SLOT(onFilterTextChanged(QString)));
+	connect(FilterEdit, SIGNAL(returnPressed()), SLOT(onFilterReturnPressed()));
+}
+
+
+//============================================================================
+void CDockAreaTabsMenu::synchronize()
+{
+	Outdated = false;
+	QHash<CDockWidgetTab*, QAction*> Actions;
+	Actions.reserve(TabBar->count());
+	auto MenuActions = actions();
+	int OpenTabs = 0;
+	for (int i = 0; i < TabBar->count(); ++i)
+	{
+		auto Tab = TabBar->tab(i);
+		auto Action = TabActions.take(Tab);
+		if (!Action)
+		{
+			Action = new QAction(this);
+		}
+		Actions.insert(Tab, Action);
+
+		// The filter action is always the first action in the menu
+		int Position = i + 1;
+		auto ActionAtPosition = MenuActions.value(Position);
+		if (ActionAtPosition != Action)
+		{
+			insertAction(ActionAtPosition, Action);
+			MenuActions.removeOne(Action);
+			MenuActions.insert(Position, Action);
+		}
+
+		Action->setText(Tab->text());
+		internal::setToolTip(Action, Tab->toolTip());
+		if (Action->icon().cacheKey() != Tab->icon().cacheKey())
+		{
+			Action->setIcon(Tab->icon());
+		}
+		if (!Action->data().isValid() || Action->data().toInt() != i)
+		{
+			Action->setData(i);
+		}
+		updateActionVisibility(Action, Tab);
+		if (!Tab->isHidden())
+		{
+			OpenTabs++;
+		}
+	}
+
+	// All remaining actions belong to tabs that have been removed
+	qDeleteAll(TabActions);
+	TabActions = Actions;
+	FilterAction->setVisible(OpenTabs >= FilterMinimumEntries);
+}
+
+
+//============================================================================
+void CDockAreaTabsMenu::updateActionVisibility(QAction* Action, CDockWidgetTab* Tab)
+{
+	const auto Filter = FilterEdit->text();
+	Action->setVisible(!Tab->isHidden() && (Filter.isEmpty()
+		|| Action->text().contains(Filter, Qt::CaseInsensitive)));
+}
+
+
+//============================================================================
+void CDockAreaTabsMenu::onAboutToShow()
+{
+	if (Outdated)
+	{
+		synchronize();
+	}
+}
+
+
+//============================================================================
+void CDockAreaTabsMenu::onAboutToHide()
+{
+	FilterEdit->clear();
+}
+
+
+//============================================================================
+void CDockAreaTabsMenu::onFilterTextChanged(const QString& Text)
+{
+	Q_UNUSED(Text);
+	for (auto it = TabActions.constBegin(); it != TabActions.constEnd(); ++it)
+	{
+		updateActionVisibility(it.value(), it.key());
+	}
+}
+
+
+//============================================================================
+void CDockAreaTabsMenu::onFilterReturnPressed()
+{
+	// If the user selected an entry, the menu triggers it
+	if (activeAction() && activeAction() != FilterAction)
+	{
+		return;
+	}
+
+	for (auto Action : actions())
+	{
+		if (Action != FilterAction && Action->isVisible())
+		{
+			Action->trigger();
+			hide();
+			return;
+		}
+	}
+}
+
+
+//============================================================================
+void CDockAreaTabsMenu::keyPressEvent(QKeyEvent* Event)
+{
+	// Typing into the open menu edits the filter text
+	if (FilterAction->isVisible() && !FilterEdit->hasFocus())
+	{
+		const auto Text = Event->text();
+		bool Printable = !Text.isEmpty() && Text.at(0).isPrint()
+			&& !(Event->modifiers() & (Qt::ControlModifier | Qt::AltModifier));
+		if (Printable || (Event->key() == Qt::Key_Backspace && !FilterEdit->text().isEmpty()))
+		{
+			FilterEdit->setFocus();
+			QApplication::sendEvent(FilterEdit, Event);
+			return;
+		}
+	}
+
+	Super::keyPressEvent(Event);
+}
+
+
 } // namespace ads
 
 //---------------------------------------------------------------------------
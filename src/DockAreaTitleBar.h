@@ -114,7 +114,6 @@ private:
 	friend struct DockAreaTitleBarPrivate;
 
 private Q_SLOTS:
-	void onTabsMenuAboutToShow();
 	void onCloseButtonClicked();
 	void onAutoHideCloseActionTriggered();
 	void minimizeAutoHideContainer();
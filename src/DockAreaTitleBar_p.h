@@ -23,7 +23,7 @@
 /// \file   DockAreaTitleBar_p.h
 /// \author Uwe Kindler
 /// \date   12.10.2018
-/// \brief  Declaration of classes CTitleBarButton and CSpacerWidget
+/// \brief  Declaration of classes CSpacerWidget and CDockAreaTabsMenu
 //============================================================================
 
 
@@ -31,11 +31,18 @@
 //                                   INCLUDES
 //============================================================================
 #include <QFrame>
+#include <QHash>
+#include <QMenu>
 
 #include "ads_globals.h"
 
+QT_FORWARD_DECLARE_CLASS(QLineEdit)
+QT_FORWARD_DECLARE_CLASS(QWidgetAction)
+
 namespace ads
 {
+class CDockAreaTabBar;
+class CDockWidgetTab;
 
 
 
@@ -57,6 +64,66 @@ public:
 	virtual QSize minimumSizeHint() const override {return QSize(0, 0);}
 };
 
+
+/**
+ * The tabs menu of the dock area title bar.
+ * The menu keeps one action per tab. If the menu is outdated, the actions
+ * are synchronized with the tab bar before the menu is shown. Only the
+ * actions of inserted, removed, moved or renamed tabs are touched - the
+ * menu is never rebuilt. If the menu contains many entries, it shows a
+ * filter field and typing into the open menu filters the entries.
+ */
+class CDockAreaTabsMenu : public QMenu
+{
+	Q_OBJECT
+private:
+	CDockAreaTabBar* TabBar;
+	QHash<CDockWidgetTab*, QAction*> TabActions;
+	QWidgetAction* FilterAction;
+	QLineEdit* FilterEdit;
+	bool Outdated = true;
+
+	/**
+	 * Updates the visibility of the given tab action depending on the open
+	 * state of the tab and the filter text
+	 */
+	void updateActionVisibility(QAction* Action, CDockWidgetTab* Tab);
+
+private Q_SLOTS:
+	void onAboutToShow();
+	void onAboutToHide();
+	void onFilterTextChanged(const QString& Text);
+	void onFilterReturnPressed();
+
+protected:
+	virtual void keyPressEvent(QKeyEvent* Event) override;
+
+public:
+	using Super = QMenu;
+
+	/**
+	 * The filter field is shown if the menu contains at least this number
+	 * of entries
+	 */
+	static const int FilterMinimumEntries = 10;
+
+	/**
+	 * Creates the tabs menu for the given tab bar
+	 */
+	CDockAreaTabsMenu(CDockAreaTabBar* TabBar, QWidget* Parent = nullptr);
+
+	/**
+	 * Marks the menu as outdated. The actions are synchronized with the tab
+	 * bar the next time the menu is shown.
+	 */
+	void markOutdated() {Outdated = true;}
+
+	/**
+	 * Synchronizes the menu actions with the tabs of the tab bar
+	 */
+	void synchronize();
+};
+
 }
  // namespace ads
 //-----------------------------------------------------------------------------
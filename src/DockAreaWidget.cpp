@@ -53,6 +53,7 @@
 #include "DockComponentsFactory.h"
 #include "DockWidgetTab.h"
 #include "DockingStateReader.h"
+#include "DockingStateWriter.h"
 
 
 namespace ads
@@ -282,6 +283,18 @@ struct DockAreaWidgetPrivate
 	 */
 	void createTitleBar();
 
+	/**
+	 * Marks the state of the dock container of this area as changed
+	 */
+	void markStateDirty()
+	{
+		auto DockContainer = _this->dockContainer();
+		if (DockContainer)
+		{
+			DockContainer->markStateDirty();
+		}
+	}
+
 	/**
 	 * Returns the dock widget with the given index
 	 */
@@ -521,6 +534,7 @@ void CDockAreaWidget::insertDockWidget(int index, CDockWidget* DockWidget,
 	{
 		index = d->ContentsLayout->count();
 	}
+	d->markStateDirty();
 	d->ContentsLayout->insertWidget(index, DockWidget);
 	DockWidget->setDockArea(this);
 	DockWidget->tabWidget()->setDockAreaWidget(this);
@@ -560,6 +574,7 @@ void CDockAreaWidget::removeDockWidget(CDockWidget* DockWidget)
     	return;
     }
 
+    d->markStateDirty();
 
     // If this dock area is in a auto hide container, then we can delete
     // the auto hide container now
@@ -722,6 +737,7 @@ void CDockAreaWidget::setCurrentIndex(int index)
 		return;
 	}
 
+    d->markStateDirty();
     Q_EMIT currentChanging(index);
     TabBar->setCurrentIndex(index);
 	d->ContentsLayout->setCurrentIndex(index);
@@ -839,6 +855,7 @@ void CDockAreaWidget::reorderDockWidget(int fromIndex, int toIndex)
 		return;
 	}
 
+	d->markStateDirty();
 	auto Widget = d->ContentsLayout->widget(fromIndex);
 	d->ContentsLayout->removeWidget(Widget);
 	d->ContentsLayout->insertWidget(toIndex, Widget);
@@ -864,6 +881,13 @@ void CDockAreaWidget::updateTitleBarVisibility()
 		return;
 	}
 
+	// Deferred until CDockManager::endLayoutUpdate()
+	auto DockManager = Container->dockManager();
+	if (DockManager && DockManager->isLayoutUpdateActive())
+	{
+		return;
+	}
+
     if (!d->TitleBar)
     {
     	return;
@@ -939,88 +963,56 @@ void CDockAreaWidget::updateTitleBarButtonsToolTips()
 //============================================================================
 void CDockAreaWidget::saveState(QXmlStreamWriter& s) const
 {
-	s.writeStartElement("Area");
-	s.writeAttribute("Tabs", QString::number(d->ContentsLayout->count()));
-	auto CurrentDockWidget = currentDockWidget();
-	QString Name = CurrentDockWidget ? CurrentDockWidget->objectName() : "";
-	s.writeAttribute("Current", Name);
+	LayoutNodeState Node;
+	saveState(Node);
+    ADS_PRINT("CDockAreaWidget::saveState TabCount: " << Node.DockWidgets.count()
+            << " Current: " << Node.CurrentDockWidget);
+	CDockingStateWriter::writeDockArea(s, Node);
+}
 
-	if (d->AllowedAreas != DefaultAllowedAreas)
-	{
-		s.writeAttribute("AllowedAreas", QString::number(d->AllowedAreas, 16));
-	}
 
-	if (d->Flags != DefaultFlags)
+//============================================================================
+void CDockAreaWidget::saveState(LayoutNodeState& Node) const
+{
+	Node.Type = LayoutNodeState::Area;
+	auto CurrentDockWidget = currentDockWidget();
+	if (CurrentDockWidget)
 	{
-		s.writeAttribute("Flags", QString::number(d->Flags, 16));
+		Node.CurrentDockWidget = CurrentDockWidget->objectName();
 	}
-    ADS_PRINT("CDockAreaWidget::saveState TabCount: " << d->ContentsLayout->count()
-            << " Current: " << Name);
+	Node.AllowedAreas = (d->AllowedAreas != DefaultAllowedAreas) ? int(d->AllowedAreas) : -1;
+	Node.Flags = (d->Flags != DefaultFlags) ? int(d->Flags) : -1;
+	Node.DockWidgets.resize(d->ContentsLayout->count());
 	for (int i = 0; i < d->ContentsLayout->count(); ++i)
 	{
-		dockWidget(i)->saveState(s);
+		dockWidget(i)->saveState(Node.DockWidgets[i]);
 	}
-	s.writeEndElement();
 }
 
 
 //============================================================================
-bool CDockAreaWidget::restoreState(CDockingStateReader& s, CDockAreaWidget*& CreatedWidget,
-		bool Testing, CDockContainerWidget* Container)
+CDockAreaWidget* CDockAreaWidget::restoreState(const LayoutNodeState& Node,
+	CDockContainerWidget* Container)
 {
-	bool Ok;
-#ifdef ADS_DEBUG_PRINT
-	int Tabs = s.attributes().value("Tabs").toInt(&Ok);
-	if (!Ok)
-	{
-		return false;
-	}
-#endif
-
-	QString CurrentDockWidget = s.attributes().value("Current").toString();
-    ADS_PRINT("Restore NodeDockArea Tabs: " << Tabs << " Current: "
-            << CurrentDockWidget);
+    ADS_PRINT("Restore NodeDockArea Tabs: " << Node.DockWidgets.count() << " Current: "
+            << Node.CurrentDockWidget);
 
     auto DockManager = Container->dockManager();
-	CDockAreaWidget* DockArea = nullptr;
-	if (!Testing)
+	CDockAreaWidget* DockArea = new CDockAreaWidget(DockManager, Container);
+	if (Node.AllowedAreas >= 0)
 	{
-		DockArea = new CDockAreaWidget(DockManager, Container);
-		const auto AllowedAreasAttribute = s.attributes().value("AllowedAreas");
-		if (!AllowedAreasAttribute.isEmpty())
-		{
-			DockArea->setAllowedAreas((DockWidgetArea)AllowedAreasAttribute.toInt(nullptr, 16));
-		}
-
-		const auto FlagsAttribute = s.attributes().value("Flags");
-		if (!FlagsAttribute.isEmpty())
-		{
-			DockArea->setDockAreaFlags((CDockAreaWidget::DockAreaFlags)FlagsAttribute.toInt(nullptr, 16));
-		}
+		DockArea->setAllowedAreas((DockWidgetArea)Node.AllowedAreas);
 	}
 
-	while (s.readNextStartElement())
+	if (Node.Flags >= 0)
 	{
-        if (s.name() != QLatin1String("Widget"))
-		{
-			continue;
-		}
-
-		auto ObjectName = s.attributes().value("Name");
-		if (ObjectName.isEmpty())
-		{
-			return false;
-		}
-
-		bool Closed = s.attributes().value("Closed").toInt(&Ok);
-		if (!Ok)
-		{
-			return false;
-		}
+		DockArea->setDockAreaFlags((CDockAreaWidget::DockAreaFlags)Node.Flags);
+	}
 
-		s.skipCurrentElement();
-		CDockWidget* DockWidget = DockManager->findDockWidget(ObjectName.toString());
-		if (!DockWidget || Testing)
+	for (const auto& WidgetState : Node.DockWidgets)
+	{
+		CDockWidget* DockWidget = DockManager->findDockWidget(WidgetState.Handle, WidgetState.Name);
+		if (!DockWidget)
 		{
 			continue;
 		}
@@ -1033,6 +1025,7 @@ bool CDockAreaWidget::restoreState(CDockingStateReader& s, CDockAreaWidget*& Cre
 
 		// We hide the DockArea here to prevent the short display (the flashing)
 		// of the dock areas during application startup
+		bool Closed = WidgetState.Closed;
 		DockArea->hide();
         DockArea->addDockWidget(DockWidget);
 		DockWidget->setToggleViewActionChecked(!Closed);
@@ -1041,23 +1034,54 @@ bool CDockAreaWidget::restoreState(CDockingStateReader& s, CDockAreaWidget*& Cre
 		DockWidget->setProperty(internal::DirtyProperty, false);
 	}
 
-	if (Testing)
-	{
-		return true;
-	}
-
 	if (!DockArea->dockWidgetsCount())
 	{
 		delete DockArea;
-		DockArea = nullptr;
+		return nullptr;
 	}
-	else
+
+	DockArea->setProperty("currentDockWidget", Node.CurrentDockWidget);
+	return DockArea;
+}
+
+
+//============================================================================
+void CDockAreaWidget::patchState(const LayoutNodeState& Node,
+	const QList<CDockWidget*>& DockWidgets)
+{
+    ADS_PRINT("Patch NodeDockArea Tabs: " << DockWidgets.count() << " Current: "
+            << Node.CurrentDockWidget);
+	setAllowedAreas((Node.AllowedAreas >= 0) ? DockWidgetAreas((DockWidgetArea)Node.AllowedAreas)
+		: DefaultAllowedAreas);
+	setDockAreaFlags((Node.Flags >= 0) ? (CDockAreaWidget::DockAreaFlags)Node.Flags
+		: CDockAreaWidget::DockAreaFlags(DefaultFlags));
+
+	auto TabBar = d->tabBar();
+	for (int i = 0; i < DockWidgets.count(); ++i)
 	{
-		DockArea->setProperty("currentDockWidget", CurrentDockWidget);
+		CDockWidget* DockWidget = DockWidgets[i];
+		// Move tab and content only if the tab order differs. The current
+		// index is fixed later by DockManagerPrivate::restoreDockAreasIndices()
+		if (index(DockWidget) != i)
+		{
+			auto TabWidget = DockWidget->tabWidget();
+			d->ContentsLayout->removeWidget(DockWidget);
+			d->ContentsLayout->insertWidget(i, DockWidget);
+			TabBar->blockSignals(true);
+			TabBar->removeTab(TabWidget);
+			TabBar->insertTab(i, TabWidget);
+			TabBar->blockSignals(false);
+			DockWidget->setProperty(INDEX_PROPERTY, i);
+		}
+
+		bool Closed = Node.DockWidgets[i].Closed;
+		DockWidget->setToggleViewActionChecked(!Closed);
+		DockWidget->setClosedState(Closed);
+		DockWidget->setProperty(internal::ClosedProperty, Closed);
+		DockWidget->setProperty(internal::DirtyProperty, false);
 	}
 
-	CreatedWidget = DockArea;
-	return true;
+	setProperty("currentDockWidget", Node.CurrentDockWidget);
 }
 
 
@@ -1155,6 +1179,11 @@ void CDockAreaWidget::toggleView(bool Open)
 void CDockAreaWidget::setVisible(bool Visible)
 {
 	Super::setVisible(Visible);
+	auto Container = dockContainer();
+	if (Container)
+	{
+		Container->updateDockAreaVisibility(this);
+	}
 	if (d->UpdateTitleBarButtons)
 	{
 		d->updateTitleBarButtonStates();
@@ -1166,6 +1195,7 @@ void CDockAreaWidget::setVisible(bool Visible)
 void CDockAreaWidget::setAllowedAreas(DockWidgetAreas areas)
 {
 	d->AllowedAreas = areas;
+	d->markStateDirty();
 }
 
 
@@ -1188,6 +1218,7 @@ void CDockAreaWidget::setDockAreaFlags(DockAreaFlags Flags)
 {
 	auto ChangedFlags = d->Flags ^ Flags;
 	d->Flags = Flags;
+	d->markStateDirty();
 	if (ChangedFlags.testFlag(HideSingleWidgetTitleBar))
 	{
 		updateTitleBarVisibility();
@@ -1493,6 +1524,14 @@ void CDockAreaWidget::setFloating()
 }
 
 
+//============================================================================
+void CDockAreaWidget::resizeEvent(QResizeEvent* event)
+{
+	d->markStateDirty();
+	Super::resizeEvent(event);
+}
+
+
 #ifdef Q_OS_WIN
 //============================================================================
 bool CDockAreaWidget::event(QEvent *e)
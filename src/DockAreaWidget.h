@@ -47,7 +47,7 @@ class CDockManager;
 class CDockContainerWidget;
 class DockContainerWidgetPrivate;
 class CDockAreaTitleBar;
-class CDockingStateReader;
+struct LayoutNodeState;
 class CDockSplitter;
 
 
@@ -98,6 +98,11 @@ private Q_SLOTS:
 	SideBarLocation calculateSideTabBarArea() const;
 
 protected:
+	/**
+	 * Marks the state of the dock container as changed, because resizing
+	 * the dock area changes the sizes of its parent splitter
+	 */
+	virtual void resizeEvent(QResizeEvent* event) override;
 
 #ifdef Q_OS_WIN
 	/**
@@ -309,12 +314,26 @@ public:
 	 */
 	void saveState(QXmlStreamWriter& Stream) const;
 
+	/**
+	 * Saves the state into the given area node of the state tree
+	 */
+	void saveState(LayoutNodeState& Node) const;
+
     /**
-	 * Restores a dock area.
-	 * \see restoreChildNodes() for details
+	 * Creates a dock area from the given parsed area node.
+	 * Returns a nullptr, if none of the dock widgets stored in the area
+	 * node exists in the dock manager.
+	 */
+    static CDockAreaWidget* restoreState(const LayoutNodeState& Node,
+		CDockContainerWidget* ParentContainer);
+
+	/**
+	 * Incremental counterpart of restoreState(). Updates this existing dock
+	 * area from the given area node instead of creating a new one.
+	 * DockWidgets contains the dock widgets of the area node in node order
+	 * and this area needs to contain exactly these dock widgets.
 	 */
-    static bool restoreState(CDockingStateReader& Stream, CDockAreaWidget*& CreatedWidget,
-		bool Testing, CDockContainerWidget* ParentContainer);
+	void patchState(const LayoutNodeState& Node, const QList<CDockWidget*>& DockWidgets);
 
 	/**
 	 * This functions returns the dock widget features of all dock widget in
@@ -43,11 +43,14 @@
 #include <QMetaObject>
 #include <QMetaType>
 #include <QApplication>
+#include <QSet>
+#include <QVector>
 
 #include "DockManager.h"
 #include "DockAreaWidget.h"
 #include "DockWidget.h"
 #include "DockingStateReader.h"
+#include "DockingStateWriter.h"
 #include "FloatingDockContainer.h"
 #include "DockOverlay.h"
 #include "ads_globals.h"
@@ -58,6 +61,8 @@
 #include "AutoHideDockContainer.h"
 #include "AutoHideSideBar.h"
 #include "AutoHideTab.h"
+#include "DockHitTestIndex.h"
+#include "DockTrace.h"
 
 #include <functional>
 #include <iostream>
@@ -132,6 +137,90 @@ static void insertWidgetIntoSplitter(QSplitter* Splitter, QWidget* widget, bool
 	}
 }
 
+/**
+ * Bookkeeping data for incremental state restoring
+ */
+struct RestorePatchContext
+{
+	QSet<QWidget*> ReusedWidgets;///< live splitters and dock areas that are reused
+	QList<QPointer<QWidget>> StaleWidgets;///< live widgets that are not used anymore
+};
+
+/**
+ * Application event filter that is shared by all expanded auto hide widgets
+ * of a dock container. The filter is only installed while at least one
+ * auto hide widget is expanded. It checks the event type once and routes
+ * only the relevant events to the expanded auto hide widgets, so the
+ * dispatch cost does not depend on the number of auto hide widgets.
+ */
+class CAutoHideEventDispatcher : public QObject
+{
+public:
+	QVector<QPointer<CAutoHideDockContainer>> ExpandedWidgets;
+
+	using QObject::QObject;
+
+	/**
+	 * Routes the application events to the given auto hide widget
+	 */
+	void addWidget(CAutoHideDockContainer* AutoHideWidget)
+	{
+		if (ExpandedWidgets.contains(AutoHideWidget))
+		{
+			return;
+		}
+
+		if (ExpandedWidgets.isEmpty())
+		{
+			qApp->installEventFilter(this);
+		}
+		ExpandedWidgets.append(AutoHideWidget);
+	}
+
+	/**
+	 * Stops routing application events to the given auto hide widget
+	 */
+	void removeWidget(CAutoHideDockContainer* AutoHideWidget)
+	{
+		if (ExpandedWidgets.isEmpty())
+		{
+			return;
+		}
+
+		ExpandedWidgets.removeAll(AutoHideWidget);
+		ExpandedWidgets.removeAll(QPointer<CAutoHideDockContainer>());
+		if (ExpandedWidgets.isEmpty())
+		{
+			qApp->removeEventFilter(this);
+		}
+	}
+
+	virtual bool eventFilter(QObject* watched, QEvent* event) override
+	{
+		auto Type = event->type();
+		if (Type != QEvent::Resize && Type != QEvent::MouseButtonPress
+		 && Type != internal::FloatingWidgetDragStartEvent
+		 && Type != internal::DockedWidgetDragStartEvent)
+		{
+			return false;
+		}
+
+		// The auto hide widgets may collapse while handling the event and
+		// remove themselves from the list, so we iterate over a copy.
+		// QObject::eventFilter() is public, so we can call the protected
+		// override of the auto hide widget via the base class
+		const auto Widgets = ExpandedWidgets;
+		for (const auto& Widget : Widgets)
+		{
+			if (Widget)
+			{
+				static_cast<QObject*>(Widget.data())->eventFilter(watched, event);
+			}
+		}
+		return false;
+	}
+};
+
 /**
  * Private data class of CDockContainerWidget class (pimpl)
  */
@@ -148,11 +237,20 @@ public:
 	CDockSplitter* RootSplitter = nullptr;
 	bool isFloating = false;
 	CDockAreaWidget* LastAddedAreaCache[5];
-	int VisibleDockAreaCount = -1;
+	QSet<const QObject*> VisibleDockAreas;
+	QList<CDockAreaWidget*> OpenedDockAreas;
+	bool OpenedDockAreasValid = false;
+	bool LayoutStatisticsValid = false;
 	CDockAreaWidget* TopLevelDockArea = nullptr;
 	QTimer DelayedAutoHideTimer;
 	CAutoHideTab* DelayedAutoHideTab;
 	bool DelayedAutoHideShow = false;
+	bool DockAreasAddedPending = false;
+	bool DockAreasRemovedPending = false;
+	CAutoHideEventDispatcher* AutoHideEventDispatcher = nullptr;
+	quint64 StateGeneration = 1;
+	quint64 CachedStateGeneration = 0;
+	DockContainerState CachedState;
 
 	/**
 	 * Private data constructor
@@ -235,45 +333,66 @@ public:
 	void appendDockAreas(const QList<CDockAreaWidget*> NewDockAreas);
 
 	/**
-	 * Save state of child nodes
+	 * Save state of the given widget and its child nodes into the state
+	 * tree. Returns the index of the appended node or -1 if the widget is
+	 * neither a splitter nor a dock area.
 	 */
-	void saveChildNodesState(QXmlStreamWriter& Stream, QWidget* Widget);
-
-	/**
-	 * Save state of auto hide widgets
-	 */
-    void saveAutoHideWidgetsState(QXmlStreamWriter& Stream);
+	int saveChildNodesState(DockContainerState& State, QWidget* Widget);
 
     /**
-	 * Restore state of child nodes.
-	 * \param[in] Stream The data stream that contains the serialized state
-	 * \param[out] CreatedWidget The widget created from parsed data or 0 if
-	 * the parsed widget was an empty splitter
-	 * \param[in] Testing If Testing is true, only the stream data is
-	 * parsed without modifying anything.
+	 * Creates the widget for the layout node with the given index.
+	 * Returns the created splitter or dock area or 0 if the node
+	 * does not contain any existing dock widget
 	 */
-	bool restoreChildNodes(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-		bool Testing);
+	QWidget* restoreNode(const DockContainerState& State, int NodeIndex);
 
 	/**
 	 * Restores a splitter.
-	 * \see restoreChildNodes() for details
+	 * \see restoreNode() for details
 	 */
-	bool restoreSplitter(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-		bool Testing);
+	QWidget* restoreSplitter(const DockContainerState& State,
+		const LayoutNodeState& Node);
 
 	/**
 	 * Restores a dock area.
-	 * \see restoreChildNodes() for details
+	 * \see restoreNode() for details
 	 */
-	bool restoreDockArea(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-		bool Testing);
+	QWidget* restoreDockArea(const LayoutNodeState& Node);
 
     /**
      * Restores a auto hide side bar
      */
-    bool restoreSideBar(CDockingStateReader& Stream, QWidget*& CreatedWidget,
-        bool Testing);
+    void restoreSideBar(const SideBarState& SideBar);
+
+	/**
+	 * Incremental counterpart of restoreNode().
+	 * Reuses the given live widget, if it is a splitter with the same
+	 * orientation as the splitter node and reuses live dock areas that
+	 * contain exactly the dock widgets of an area node. Only nodes that
+	 * differ are created. Live widgets that are not reused anymore are
+	 * collected in the StaleWidgets list of the given context.
+	 */
+	QWidget* patchNode(const DockContainerState& State, int NodeIndex,
+		QWidget* LiveWidget, RestorePatchContext& Context);
+
+	/**
+	 * Patches a splitter.
+	 * \see patchNode() for details
+	 */
+	QWidget* patchSplitter(const DockContainerState& State,
+		const LayoutNodeState& Node, QWidget* LiveWidget, RestorePatchContext& Context);
+
+	/**
+	 * Patches a dock area.
+	 * \see patchNode() for details
+	 */
+	QWidget* patchDockArea(const LayoutNodeState& Node, RestorePatchContext& Context);
+
+	/**
+	 * Patches the existing layout of this container to match the given
+	 * state and returns the new root splitter.
+	 */
+	QWidget* patchLayout(const DockContainerState& State);
 
 	/**
 	 * Helper function for recursive dumping of layout
@@ -286,36 +405,88 @@ public:
 	eDropMode getDropMode(const QPoint& TargetPos);
 
 	/**
-	 * Initializes the visible dock area count variable if it is not initialized
-	 * yet
+	 * Invalidates the layout statistics after bulk changes of the dock
+	 * areas list. The statistics are recalculated on next access.
 	 */
-	void initVisibleDockAreaCount()
+	void invalidateLayoutStatistics()
 	{
-		if (VisibleDockAreaCount > -1)
+		LayoutStatisticsValid = false;
+		OpenedDockAreasValid = false;
+		++StateGeneration;
+	}
+
+	/**
+	 * Recalculates the set of visible dock areas if the layout statistics
+	 * have been invalidated. Single dock area changes are tracked
+	 * incrementally in updateDockAreaVisibility().
+	 */
+	void updateLayoutStatistics()
+	{
+		if (LayoutStatisticsValid)
 		{
 			return;
 		}
 
-		VisibleDockAreaCount = 0;
+		VisibleDockAreas.clear();
 		for (auto DockArea : DockAreas)
 		{
-			if (!DockArea)
+			if (DockArea && !DockArea->isHidden())
 			{
-				continue;
+				VisibleDockAreas.insert(DockArea);
 			}
-			VisibleDockAreaCount += (DockArea->isHidden() ? 0 : 1);
 		}
+		LayoutStatisticsValid = true;
+		OpenedDockAreasValid = false;
 	}
 
 	/**
-	 * Access function for the visible dock area counter
+	 * Returns the cached list of opened dock areas in the order of the
+	 * DockAreas list
 	 */
-	int& visibleDockAreaCount()
+	const QList<CDockAreaWidget*>& openedDockAreas()
 	{
-		// Lazy initialisation - we initialize the VisibleDockAreaCount variable
-		// on first use
-		initVisibleDockAreaCount();
-		return VisibleDockAreaCount;
+		updateLayoutStatistics();
+		if (!OpenedDockAreasValid)
+		{
+			OpenedDockAreas.clear();
+			for (auto DockArea : DockAreas)
+			{
+				if (DockArea && VisibleDockAreas.contains(DockArea))
+				{
+					OpenedDockAreas.append(DockArea);
+				}
+			}
+			OpenedDockAreasValid = true;
+		}
+		return OpenedDockAreas;
+	}
+
+	/**
+	 * Updates the visible dock area set if the visibility of the given dock
+	 * area changed
+	 */
+	void updateDockAreaVisibility(CDockAreaWidget* DockArea)
+	{
+		if (!LayoutStatisticsValid)
+		{
+			return;
+		}
+
+		bool Visible = !DockArea->isHidden();
+		if (Visible == VisibleDockAreas.contains(DockArea))
+		{
+			return;
+		}
+
+		if (!Visible)
+		{
+			VisibleDockAreas.remove(DockArea);
+		}
+		else if (DockAreas.contains(DockArea))
+		{
+			VisibleDockAreas.insert(DockArea);
+		}
+		OpenedDockAreasValid = false;
 	}
 
 	/**
@@ -326,16 +497,41 @@ public:
 
 	void emitDockAreasRemoved()
 	{
+		++StateGeneration;
+		if (isLayoutUpdateActive())
+		{
+			DockAreasRemovedPending = true;
+			return;
+		}
 		onVisibleDockAreaCountChanged();
 		Q_EMIT _this->dockAreasRemoved();
 	}
 
 	void emitDockAreasAdded()
 	{
+		++StateGeneration;
+		if (isLayoutUpdateActive())
+		{
+			DockAreasAddedPending = true;
+			return;
+		}
 		onVisibleDockAreaCountChanged();
 		Q_EMIT _this->dockAreasAdded();
 	}
 
+	/**
+	 * Returns true, if the dock manager defers layout updates
+	 */
+	bool isLayoutUpdateActive() const
+	{
+		return DockManager && DockManager->isLayoutUpdateActive();
+	}
+
+	/**
+	 * Updates the handles of the given splitter and of all its child splitters
+	 */
+	void updateSplitterHandlesRecursive(QSplitter* Splitter);
+
 	/**
 	 * Helper function for creation of new splitter
 	 */
@@ -382,7 +578,6 @@ public:
 	void onDockAreaViewToggled(bool Visible)
 	{
 		CDockAreaWidget* DockArea = qobject_cast<CDockAreaWidget*>(_this->sender());
-		VisibleDockAreaCount += Visible ? 1 : -1;
 		onVisibleDockAreaCountChanged();
 		Q_EMIT _this->dockAreaViewToggled(DockArea, Visible);
 	}
@@ -817,6 +1012,12 @@ void DockContainerWidgetPrivate::updateSplitterHandles( QSplitter* splitter )
 		return;
 	}
 
+	// All splitters are updated once in CDockManager::endLayoutUpdate()
+	if (DockManager->isLayoutUpdateActive())
+	{
+		return;
+	}
+
 	for (int i = 0; i < splitter->count(); ++i)
     {
 		splitter->setStretchFactor(i, widgetResizesWithContainer(splitter->widget(i)) ? 1 : 0);
@@ -824,6 +1025,21 @@ void DockContainerWidgetPrivate::updateSplitterHandles( QSplitter* splitter )
 }
 
 
+//============================================================================
+void DockContainerWidgetPrivate::updateSplitterHandlesRecursive(QSplitter* Splitter)
+{
+	updateSplitterHandles(Splitter);
+	for (int i = 0; i < Splitter->count(); ++i)
+	{
+		auto ChildSplitter = qobject_cast<CDockSplitter*>(Splitter->widget(i));
+		if (ChildSplitter)
+		{
+			updateSplitterHandlesRecursive(ChildSplitter);
+		}
+	}
+}
+
+
 //============================================================================
 bool DockContainerWidgetPrivate::widgetResizesWithContainer(QWidget* widget)
 {
@@ -932,302 +1148,327 @@ void DockContainerWidgetPrivate::appendDockAreas(const QList<CDockAreaWidget*> N
 	{
 		DockAreas.append(newDockArea);
 	}
+	OpenedDockAreasValid = false;
 	for (auto DockArea : NewDockAreas)
 	{
+		updateDockAreaVisibility(DockArea);
 		QObject::connect(DockArea,
 			&CDockAreaWidget::viewToggled,
 			_this,
 			std::bind(&DockContainerWidgetPrivate::onDockAreaViewToggled, this, std::placeholders::_1));
+		QObject::connect(DockArea, &QObject::destroyed, _this, [this](QObject* Object)
+			{
+				if (VisibleDockAreas.remove(Object))
+				{
+					OpenedDockAreasValid = false;
+				}
+			});
 	}
 }
 
 
 //============================================================================
-void DockContainerWidgetPrivate::saveChildNodesState(QXmlStreamWriter& s, QWidget* Widget)
+int DockContainerWidgetPrivate::saveChildNodesState(DockContainerState& State,
+	QWidget* Widget)
 {
 	QSplitter* Splitter = qobject_cast<QSplitter*>(Widget);
 	if (Splitter)
 	{
-		s.writeStartElement("Splitter");
-		s.writeAttribute("Orientation", (Splitter->orientation() == Qt::Horizontal) ? "|" : "-");
-		s.writeAttribute("Count", QString::number(Splitter->count()));
-        ADS_PRINT("NodeSplitter orient: " << Splitter->orientation()
-            << " WidgetCont: " << Splitter->count());
-			for (int i = 0; i < Splitter->count(); ++i)
+		LayoutNodeState Node;
+		Node.Type = LayoutNodeState::Splitter;
+		Node.Orientation = Splitter->orientation();
+		Node.Children.reserve(Splitter->count());
+		for (int i = 0; i < Splitter->count(); ++i)
+		{
+			int Child = saveChildNodesState(State, Splitter->widget(i));
+			if (Child >= 0)
 			{
-				saveChildNodesState(s, Splitter->widget(i));
+				Node.Children.append(Child);
 			}
+		}
+		Node.Sizes = Splitter->sizes();
+		State.Nodes.append(Node);
+		return State.Nodes.count() - 1;
+	}
 
-			s.writeStartElement("Sizes");
-			for (auto Size : Splitter->sizes())
-			{
-				s.writeCharacters(QString::number(Size) + " ");
-			}
-			s.writeEndElement();
-		s.writeEndElement();
+	CDockAreaWidget* DockArea = qobject_cast<CDockAreaWidget*>(Widget);
+	if (DockArea)
+	{
+		State.Nodes.append(LayoutNodeState());
+		DockArea->saveState(State.Nodes.last());
+		return State.Nodes.count() - 1;
+	}
+
+	return -1;
+}
+
+
+//============================================================================
+QWidget* DockContainerWidgetPrivate::restoreNode(const DockContainerState& State,
+	int NodeIndex)
+{
+	const auto& Node = State.Nodes[NodeIndex];
+	if (LayoutNodeState::Splitter == Node.Type)
+	{
+		return restoreSplitter(State, Node);
 	}
 	else
 	{
-		CDockAreaWidget* DockArea = qobject_cast<CDockAreaWidget*>(Widget);
-		if (DockArea)
-		{
-			DockArea->saveState(s);
-		}
+		return restoreDockArea(Node);
 	}
 }
 
 
 //============================================================================
-void DockContainerWidgetPrivate::saveAutoHideWidgetsState(QXmlStreamWriter& s)
+QWidget* DockContainerWidgetPrivate::restoreSplitter(const DockContainerState& State,
+	const LayoutNodeState& Node)
 {
-	for (const auto sideTabBar : SideTabBarWidgets.values())
-    {
-		if (!sideTabBar->count())
+    ADS_PRINT("Restore NodeSplitter Orientation: " <<  Node.Orientation <<
+            " WidgetCount: " << Node.Sizes.count());
+	QSplitter* Splitter = newSplitter(Node.Orientation);
+	bool Visible = false;
+	for (auto ChildIndex : Node.Children)
+	{
+		QWidget* ChildNode = restoreNode(State, ChildIndex);
+		if (!ChildNode)
 		{
 			continue;
 		}
 
-		sideTabBar->saveState(s);
-    }
+        ADS_PRINT("ChildNode isVisible " << ChildNode->isVisible()
+            << " isVisibleTo " << ChildNode->isVisibleTo(Splitter));
+		Splitter->addWidget(ChildNode);
+		Visible |= ChildNode->isVisibleTo(Splitter);
+	}
+	updateSplitterHandles(Splitter);
+
+	if (!Splitter->count())
+	{
+		delete Splitter;
+		return nullptr;
+	}
+
+	Splitter->setSizes(Node.Sizes);
+	Splitter->setVisible(Visible);
+	return Splitter;
 }
 
 
 //============================================================================
-bool DockContainerWidgetPrivate::restoreSplitter(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
+QWidget* DockContainerWidgetPrivate::restoreDockArea(const LayoutNodeState& Node)
 {
-	bool Ok;
-	QString OrientationStr = s.attributes().value("Orientation").toString();
-
-	// Check if the orientation string is right
-	if (!OrientationStr.startsWith("|") && !OrientationStr.startsWith("-"))
+	CDockAreaWidget* DockArea = CDockAreaWidget::restoreState(Node, _this);
+	if (DockArea)
 	{
-		return false;
+		appendDockAreas({DockArea});
 	}
+	return DockArea;
+}
 
-	// The "|" shall indicate a vertical splitter handle which in turn means
-	// a Horizontal orientation of the splitter layout.
-	bool HorizontalSplitter = OrientationStr.startsWith("|");
-	// In version 0 we had a small bug. The "|" indicated a vertical orientation,
-	// but this is wrong, because only the splitter handle is vertical, the
-	// layout of the splitter is a horizontal layout. We fix this here
-	if (s.fileVersion() == 0)
-	{
-		HorizontalSplitter = !HorizontalSplitter;
-	}
 
-	int Orientation = HorizontalSplitter ? Qt::Horizontal : Qt::Vertical;
-	int WidgetCount = s.attributes().value("Count").toInt(&Ok);
-	if (!Ok)
-	{
-		return false;
-	}
-    ADS_PRINT("Restore NodeSplitter Orientation: " <<  Orientation <<
-            " WidgetCount: " << WidgetCount);
-	QSplitter* Splitter = nullptr;
-	if (!Testing)
+//============================================================================
+void DockContainerWidgetPrivate::restoreSideBar(const SideBarState& SideBar)
+{
+	// There are no side bars if auto hide support is disabled
+	auto AutoHideSideBar = _this->autoHideSideBar(SideBar.Area);
+	if (!AutoHideSideBar)
 	{
-		Splitter = newSplitter(static_cast<Qt::Orientation>(Orientation));
+		return;
 	}
-	bool Visible = false;
-	QList<int> Sizes;
-	while (s.readNextStartElement())
+
+	for (const auto& WidgetState : SideBar.DockWidgets)
 	{
-		QWidget* ChildNode = nullptr;
-		bool Result = true;
-        if (s.name() == QLatin1String("Splitter"))
-		{
-			Result = restoreSplitter(s, ChildNode, Testing);
-		}
-        else if (s.name() == QLatin1String("Area"))
+		CDockWidget* DockWidget = DockManager->findDockWidget(WidgetState.Handle, WidgetState.Name);
+		if (!DockWidget)
 		{
-			Result = restoreDockArea(s, ChildNode, Testing);
+			continue;
 		}
-        else if (s.name() == QLatin1String("Sizes"))
+
+		CAutoHideDockContainer* AutoHideContainer;
+		if (DockWidget->isAutoHide())
 		{
-			QString sSizes = s.readElementText().trimmed();
-            ADS_PRINT("Sizes: " << sSizes);
-			QTextStream TextStream(&sSizes);
-			while (!TextStream.atEnd())
+			AutoHideContainer = DockWidget->autoHideDockContainer();
+			if (AutoHideContainer->autoHideSideBar() != AutoHideSideBar)
 			{
-				int value;
-				TextStream >> value;
-				Sizes.append(value);
+				AutoHideSideBar->addAutoHideWidget(AutoHideContainer);
 			}
 		}
 		else
 		{
-			s.skipCurrentElement();
+			AutoHideContainer = AutoHideSideBar->insertDockWidget(-1, DockWidget);
 		}
-
-		if (!Result)
-		{
-			return false;
-		}
-
-		if (Testing || !ChildNode)
-		{
-			continue;
-		}
-
-        ADS_PRINT("ChildNode isVisible " << ChildNode->isVisible()
-            << " isVisibleTo " << ChildNode->isVisibleTo(Splitter));
-		Splitter->addWidget(ChildNode);
-		Visible |= ChildNode->isVisibleTo(Splitter);
+		AutoHideContainer->setSize(WidgetState.Size);
+        DockWidget->setProperty(internal::ClosedProperty, WidgetState.Closed);
+		DockWidget->setProperty(internal::DirtyProperty, false);
 	}
-    if(!Testing)
-    {
-       updateSplitterHandles(Splitter);
-    }
+}
 
-	if (Sizes.count() != WidgetCount)
-	{
-		return false;
-	}
 
-	if (!Testing)
+//============================================================================
+QWidget* DockContainerWidgetPrivate::patchNode(const DockContainerState& State,
+	int NodeIndex, QWidget* LiveWidget, RestorePatchContext& Context)
+{
+	const auto& Node = State.Nodes[NodeIndex];
+	if (LayoutNodeState::Splitter == Node.Type)
 	{
-		if (!Splitter->count())
-		{
-			delete Splitter;
-			Splitter = nullptr;
-		}
-		else
-		{
-			Splitter->setSizes(Sizes);
-			Splitter->setVisible(Visible);
-		}
-		CreatedWidget = Splitter;
+		return patchSplitter(State, Node, LiveWidget, Context);
 	}
 	else
 	{
-		CreatedWidget = nullptr;
+		return patchDockArea(Node, Context);
 	}
-
-	return true;
 }
 
 
 //============================================================================
-bool DockContainerWidgetPrivate::restoreDockArea(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
+QWidget* DockContainerWidgetPrivate::patchSplitter(const DockContainerState& State,
+	const LayoutNodeState& Node, QWidget* LiveWidget, RestorePatchContext& Context)
 {
-	CDockAreaWidget* DockArea = nullptr;
-	auto Result = CDockAreaWidget::restoreState(s, DockArea, Testing, _this);
-	if (Result && DockArea)
+	auto Splitter = qobject_cast<CDockSplitter*>(LiveWidget);
+	if (!Splitter || Splitter->orientation() != Node.Orientation
+	 || Context.ReusedWidgets.contains(Splitter))
 	{
-		appendDockAreas({DockArea});
+		Splitter = newSplitter(Node.Orientation);
 	}
-	CreatedWidget = DockArea;
-	return Result;
-}
-
+	Context.ReusedWidgets.insert(Splitter);
+	ADS_PRINT("Patch NodeSplitter Orientation: " <<  Node.Orientation <<
+		" Reused: " << (Splitter == LiveWidget));
 
-//============================================================================
-bool DockContainerWidgetPrivate::restoreSideBar(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
-{
-	Q_UNUSED(CreatedWidget)
-	// Simply ignore side bar auto hide widgets from saved state if
-	// auto hide support is disabled
-	if (!CDockManager::testAutoHideConfigFlag(CDockManager::AutoHideFeatureEnabled))
+	// We take a snapshot of the live children first, because patching the
+	// child nodes may move live widgets between splitters
+	QList<QWidget*> LiveChildren;
+	for (int i = 0; i < Splitter->count(); ++i)
 	{
-		return true;
+		LiveChildren.append(Splitter->widget(i));
 	}
 
-	bool Ok;
-	auto Area = (ads::SideBarLocation)s.attributes().value("Area").toInt(&Ok);
-	if (!Ok)
+	QList<QWidget*> Children;
+	for (int i = 0; i < Node.Children.count(); ++i)
 	{
-		return false;
+		QWidget* LiveChild = (i < LiveChildren.count()) ? LiveChildren[i] : nullptr;
+		QWidget* ChildNode = patchNode(State, Node.Children[i], LiveChild, Context);
+		if (ChildNode)
+		{
+			Children.append(ChildNode);
+		}
 	}
 
-	while (s.readNextStartElement())
+	// Move or insert only the children that are not at the right position
+	bool Visible = false;
+	for (int i = 0; i < Children.count(); ++i)
 	{
-		if (s.name() != QLatin1String("Widget"))
+		QWidget* ChildNode = Children[i];
+		if (Splitter->indexOf(ChildNode) != i)
 		{
-			continue;
+			Splitter->insertWidget(i, ChildNode);
 		}
+		Visible |= ChildNode->isVisibleTo(Splitter);
+	}
 
-		auto Name = s.attributes().value("Name");
-		if (Name.isEmpty())
-		{
-			return false;
-		}
+	// All remaining live widgets are not used anymore. We keep them parented
+	// to this container until the patching is finished because they may still
+	// contain dock areas or splitters that are reused by other nodes
+	while (Splitter->count() > Children.count())
+	{
+		QWidget* StaleWidget = Splitter->widget(Children.count());
+		StaleWidget->hide();
+		StaleWidget->setParent(_this);
+		Context.StaleWidgets.append(StaleWidget);
+	}
+	updateSplitterHandles(Splitter);
 
-		bool Ok;
-		bool Closed = s.attributes().value("Closed").toInt(&Ok);
-		if (!Ok)
+	if (!Splitter->count())
+	{
+		Context.ReusedWidgets.remove(Splitter);
+		if (Splitter == LiveWidget)
 		{
-			return false;
+			Context.StaleWidgets.append(Splitter);
 		}
-
-		int Size = s.attributes().value("Size").toInt(&Ok);
-		if (!Ok)
+		else
 		{
-			return false;
+			delete Splitter;
 		}
+		return nullptr;
+	}
 
-		s.skipCurrentElement();
-		CDockWidget* DockWidget = DockManager->findDockWidget(Name.toString());
-		if (!DockWidget || Testing)
-		{
-			continue;
-		}
+	if (Splitter->sizes() != Node.Sizes)
+	{
+		Splitter->setSizes(Node.Sizes);
+	}
+	Splitter->setVisible(Visible);
+	return Splitter;
+}
 
-		auto SideBar = _this->autoHideSideBar(Area);
-		CAutoHideDockContainer* AutoHideContainer;
-		if (DockWidget->isAutoHide())
-		{
-			AutoHideContainer = DockWidget->autoHideDockContainer();
-			if (AutoHideContainer->autoHideSideBar() != SideBar)
-			{
-				SideBar->addAutoHideWidget(AutoHideContainer);
-			}
-		}
-		else
+
+//============================================================================
+QWidget* DockContainerWidgetPrivate::patchDockArea(const LayoutNodeState& Node,
+	RestorePatchContext& Context)
+{
+	// An existing dock area is reused, if it contains exactly the dock widgets
+	// of the area node. Otherwise we create a new dock area.
+	QList<CDockWidget*> DockWidgets;
+	for (const auto& WidgetState : Node.DockWidgets)
+	{
+		CDockWidget* DockWidget = DockManager->findDockWidget(WidgetState.Handle, WidgetState.Name);
+		if (!DockWidget)
 		{
-			AutoHideContainer = SideBar->insertDockWidget(-1, DockWidget);
+			break;
 		}
-		AutoHideContainer->setSize(Size);
-        DockWidget->setProperty(internal::ClosedProperty, Closed);
-		DockWidget->setProperty(internal::DirtyProperty, false);
+		DockWidgets.append(DockWidget);
 	}
 
-	return true;
+	CDockAreaWidget* DockArea = DockWidgets.isEmpty() ? nullptr : DockWidgets.first()->dockAreaWidget();
+	bool Reuse = DockArea && (DockWidgets.count() == Node.DockWidgets.count())
+		&& !DockArea->isAutoHide()
+		&& !Context.ReusedWidgets.contains(DockArea)
+		&& (DockArea->dockContainer() == _this)
+		&& (DockArea->dockWidgetsCount() == DockWidgets.count());
+	for (int i = 1; Reuse && i < DockWidgets.count(); ++i)
+	{
+		Reuse = (DockWidgets[i]->dockAreaWidget() == DockArea);
+	}
+
+	if (!Reuse)
+	{
+		return restoreDockArea(Node);
+	}
+
+	Context.ReusedWidgets.insert(DockArea);
+	DockArea->patchState(Node, DockWidgets);
+	DockAreas.append(DockArea);
+	return DockArea;
 }
 
 
 //============================================================================
-bool DockContainerWidgetPrivate::restoreChildNodes(CDockingStateReader& s,
-	QWidget*& CreatedWidget, bool Testing)
+QWidget* DockContainerWidgetPrivate::patchLayout(const DockContainerState& State)
 {
-	bool Result = true;
-	while (s.readNextStartElement())
+	auto OldDockAreas = DockAreas;
+	DockAreas.clear();
+	invalidateLayoutStatistics();
+	RestorePatchContext Context;
+	QWidget* NewRootSplitter = (State.RootNode < 0) ? nullptr
+		: patchNode(State, State.RootNode, RootSplitter, Context);
+
+	// Dock areas that are not reused anymore are deleted later with
+	// their parent splitters
+	for (auto DockArea : OldDockAreas)
 	{
-        if (s.name() == QLatin1String("Splitter"))
+		if (DockArea && !Context.ReusedWidgets.contains(DockArea))
 		{
-			Result = restoreSplitter(s, CreatedWidget, Testing);
-            ADS_PRINT("Splitter");
+			QObject::disconnect(DockArea, SIGNAL(viewToggled(bool)), _this, nullptr);
 		}
-        else if (s.name() == QLatin1String("Area"))
-		{
-			Result = restoreDockArea(s, CreatedWidget, Testing);
-            ADS_PRINT("DockAreaWidget");
-		}
-        else if (s.name() == QLatin1String("SideBar"))
-        {
-        	Result = restoreSideBar(s, CreatedWidget, Testing);
-        	ADS_PRINT("SideBar");
-        }
-		else
+	}
+
+	for (auto StaleWidget : Context.StaleWidgets)
+	{
+		if (StaleWidget && StaleWidget != RootSplitter)
 		{
-			s.skipCurrentElement();
-            ADS_PRINT("Unknown element");
+			StaleWidget->deleteLater();
 		}
 	}
 
-	return Result;
+	return NewRootSplitter;
 }
 
 
@@ -1435,6 +1676,15 @@ CDockContainerWidget::~CDockContainerWidget()
 		d->DockManager->removeDockContainer(this);
 	}
 
+	// The dock areas are deleted after the private data, so the connections
+	// to the private data need to be removed here
+	for (auto DockArea : d->DockAreas)
+	{
+		if (DockArea)
+		{
+			DockArea->disconnect(this);
+		}
+	}
 	delete d;
 }
 
@@ -1531,6 +1781,11 @@ bool CDockContainerWidget::event(QEvent *e)
 	{
 		d->zOrderIndex = ++zOrderCounter;
 	}
+	else if (e->type() == QEvent::Resize)
+	{
+		// The splitter sizes change with the size of the container
+		markStateDirty();
+	}
 
 	return Result;
 }
@@ -1570,6 +1825,8 @@ void CDockContainerWidget::removeDockArea(CDockAreaWidget* area)
 
 	area->disconnect(this);
 	d->DockAreas.removeAll(area);
+	d->VisibleDockAreas.remove(area);
+	d->OpenedDockAreasValid = false;
 	auto Splitter = area->parentSplitter();
 
 	// Remove are from parent splitter and recursively hide tree of parent
@@ -1648,6 +1905,7 @@ QList<QPointer<CDockAreaWidget>> CDockContainerWidget::removeAllDockAreas()
 {
 	auto Result = d->DockAreas;
 	d->DockAreas.clear();
+	d->invalidateLayoutStatistics();
 	return Result;
 }
 
@@ -1655,6 +1913,14 @@ QList<QPointer<CDockAreaWidget>> CDockContainerWidget::removeAllDockAreas()
 //============================================================================
 CDockAreaWidget* CDockContainerWidget::dockAreaAt(const QPoint& GlobalPos) const
 {
+	// During drag operations the lookup uses the hit test index of the
+	// dock manager instead of testing all dock areas
+	auto HitTestIndex = d->DockManager ? d->DockManager->hitTestIndex() : nullptr;
+	if (HitTestIndex && HitTestIndex->isDragActive() && HitTestIndex->isIndexed(this))
+	{
+		return HitTestIndex->dockAreaAt(this, GlobalPos);
+	}
+
 	for (const auto& DockArea : d->DockAreas)
 	{
 		if (DockArea && DockArea->isVisible() && DockArea->rect().contains(DockArea->mapFromGlobal(GlobalPos)))
@@ -1691,17 +1957,26 @@ int CDockContainerWidget::dockAreaCount() const
 //============================================================================
 int CDockContainerWidget::visibleDockAreaCount() const
 {
-	int Result = 0;
-	for (auto DockArea : d->DockAreas)
-	{
-		Result += (!DockArea || DockArea->isHidden()) ? 0 : 1;
-	}
+	d->updateLayoutStatistics();
+	return d->VisibleDockAreas.count();
+}
 
-	return Result;
 
-	// TODO Cache or precalculate this to speed it up because it is used during
-	// movement of floating widget
-	//return d->visibleDockAreaCount();
+//============================================================================
+DockLayoutStatistics CDockContainerWidget::layoutStatistics() const
+{
+	DockLayoutStatistics Statistics;
+	Statistics.DockAreas = d->DockAreas.count();
+	Statistics.VisibleDockAreas = visibleDockAreaCount();
+	Statistics.TopLevelDockArea = topLevelDockArea();
+	return Statistics;
+}
+
+
+//============================================================================
+void CDockContainerWidget::updateDockAreaVisibility(CDockAreaWidget* DockArea)
+{
+	d->updateDockAreaVisibility(DockArea);
 }
 
 
@@ -1710,6 +1985,8 @@ void CDockContainerWidget::dropFloatingWidget(CFloatingDockContainer* FloatingWi
 	const QPoint& TargetPos)
 {
     ADS_PRINT("CDockContainerWidget::dropFloatingWidget");
+    ADS_TRACE_SCOPE_CATEGORY("dropFloatingWidget", "drag");
+	markStateDirty();
 	CDockWidget* SingleDroppedDockWidget = FloatingWidget->topLevelDockWidget();
 	CDockWidget* SingleDockWidget = topLevelDockWidget();
 	auto dropArea = InvalidDockWidgetArea;
@@ -1966,6 +2243,8 @@ bool CDockContainerWidget::restoreFloatingWidgetToSource(CFloatingDockContainer*
 void CDockContainerWidget::dropWidget(QWidget* Widget, DockWidgetArea DropArea, CDockAreaWidget* TargetAreaWidget,
 	int TabIndex)
 {
+    ADS_TRACE_SCOPE_CATEGORY("dropWidget", "drag");
+	markStateDirty();
     CDockWidget* SingleDockWidget = topLevelDockWidget();
 	if (TargetAreaWidget)
 	{
@@ -1992,16 +2271,7 @@ void CDockContainerWidget::dropWidget(QWidget* Widget, DockWidgetArea DropArea,
 //============================================================================
 QList<CDockAreaWidget*> CDockContainerWidget::openedDockAreas() const
 {
-	QList<CDockAreaWidget*> Result;
-	for (auto DockArea : d->DockAreas)
-	{
-		if (DockArea && !DockArea->isHidden())
-		{
-			Result.append(DockArea);
-		}
-	}
-
-	return Result;
+	return d->openedDockAreas();
 }
 
 
@@ -2009,12 +2279,9 @@ QList<CDockAreaWidget*> CDockContainerWidget::openedDockAreas() const
 QList<CDockWidget*> CDockContainerWidget::openedDockWidgets() const
 {
 	QList<CDockWidget*> DockWidgetList;
-	for (auto DockArea : d->DockAreas)
+	for (auto DockArea : d->openedDockAreas())
 	{
-		if (DockArea && !DockArea->isHidden())
-		{
-			DockWidgetList.append(DockArea->openedDockWidgets());
-		}
+		DockWidgetList.append(DockArea->openedDockWidgets());
 	}
 
 	return DockWidgetList;
@@ -2024,105 +2291,133 @@ QList<CDockWidget*> CDockContainerWidget::openedDockWidgets() const
 //============================================================================
 bool CDockContainerWidget::hasOpenDockAreas() const
 {
-	for (auto DockArea : d->DockAreas)
+	return visibleDockAreaCount() > 0;
+}
+
+
+//============================================================================
+void CDockContainerWidget::saveState(QXmlStreamWriter& s) const
+{
+    ADS_PRINT("CDockContainerWidget::saveState isFloating "
+        << isFloating());
+
+	DockContainerState State;
+	saveState(State);
+	CDockingStateWriter::writeContainer(s, State);
+}
+
+
+//============================================================================
+void CDockContainerWidget::saveState(DockContainerState& State) const
+{
+	bool UseCache = d->DockManager && d->DockManager->isIncrementalSaveEnabled();
+	if (UseCache && d->CachedStateGeneration == d->StateGeneration)
 	{
-		if (DockArea && !DockArea->isHidden())
+		// Floating widgets are moved without notifying the container, so
+		// we compare the cached geometry with the current one
+		if (!isFloating() || floatingWidget()->saveGeometry() == d->CachedState.Geometry)
 		{
-			return true;
+			State = d->CachedState;
+			return;
 		}
+		++d->StateGeneration;
 	}
 
-	return false;
+	State.Floating = isFloating();
+	if (State.Floating)
+	{
+		State.Geometry = floatingWidget()->saveGeometry();
+	}
+	State.RootNode = d->saveChildNodesState(State, d->RootSplitter);
+	for (const auto SideTabBar : d->SideTabBarWidgets)
+	{
+		if (!SideTabBar->count())
+		{
+			continue;
+		}
+
+		State.SideBars.append(SideBarState());
+		SideTabBar->saveState(State.SideBars.last());
+	}
+
+	if (UseCache)
+	{
+		d->CachedState = State;
+		d->CachedStateGeneration = d->StateGeneration;
+	}
 }
 
 
 //============================================================================
-void CDockContainerWidget::saveState(QXmlStreamWriter& s) const
+bool CDockContainerWidget::saveState(QIODevice* Device) const
 {
-    ADS_PRINT("CDockContainerWidget::saveState isFloating "
-        << isFloating());
-
-	s.writeStartElement("Container");
-	s.writeAttribute("Floating", QString::number(isFloating() ? 1 : 0));
-	if (isFloating())
+	ADS_TRACE_SCOPE_CATEGORY("saveContainerState", "state");
+	if (!Device || !Device->isWritable())
 	{
-		CFloatingDockContainer* FloatingWidget = floatingWidget();
-		QByteArray Geometry = FloatingWidget->saveGeometry();
-#if QT_VERSION < 0x050900
-        s.writeTextElement("Geometry", qByteArrayToHex(Geometry, ' '));
-#else
-		s.writeTextElement("Geometry", Geometry.toHex(' '));
-#endif
+		return false;
 	}
-	d->saveChildNodesState(s, d->RootSplitter);
-	d->saveAutoHideWidgetsState(s);
-	s.writeEndElement();
+
+	DockContainerState State;
+	saveState(State);
+	return CDockingStateWriter::writeContainerXml(State, Device,
+		CDockManager::testConfigFlag(CDockManager::XmlAutoFormattingEnabled));
 }
 
 
 //============================================================================
-bool CDockContainerWidget::restoreState(CDockingStateReader& s, bool Testing)
+void CDockContainerWidget::restoreState(const DockContainerState& State)
 {
-	bool IsFloating = s.attributes().value("Floating").toInt();
-    ADS_PRINT("Restore CDockContainerWidget Floating" << IsFloating);
+    ADS_PRINT("Restore CDockContainerWidget Floating" << State.Floating);
 
-	QWidget* NewRootSplitter {};
-	if (!Testing)
+	bool Incremental = d->DockManager && d->DockManager->isIncrementalRestoreEnabled();
+	d->invalidateLayoutStatistics();
+	if (!Incremental)
 	{
-		d->VisibleDockAreaCount = -1;// invalidate the dock area count
 		d->DockAreas.clear();
-		std::fill(std::begin(d->LastAddedAreaCache),std::end(d->LastAddedAreaCache), nullptr);
 	}
+	std::fill(std::begin(d->LastAddedAreaCache),std::end(d->LastAddedAreaCache), nullptr);
 
-	if (IsFloating)
+	if (State.Floating)
 	{
         ADS_PRINT("Restore floating widget");
-        if (!s.readNextStartElement() || s.name() != QLatin1String("Geometry"))
-		{
-			return false;
-		}
-
-		QByteArray GeometryString = s.readElementText(CDockingStateReader::ErrorOnUnexpectedElement).toLocal8Bit();
-		QByteArray Geometry = QByteArray::fromHex(GeometryString);
-		if (Geometry.isEmpty())
-		{
-			return false;
-		}
-
-		if (!Testing)
+		CFloatingDockContainer* FloatingWidget = floatingWidget();
+		if (FloatingWidget)
 		{
-			CFloatingDockContainer* FloatingWidget = floatingWidget();
-			if (FloatingWidget)
-			{
-				FloatingWidget->restoreGeometry(Geometry);
-			}
+			FloatingWidget->restoreGeometry(State.Geometry);
 		}
 	}
 
-	if (!d->restoreChildNodes(s, NewRootSplitter, Testing))
+	QWidget* NewRootSplitter = nullptr;
+	if (Incremental)
 	{
-		return false;
+		NewRootSplitter = d->patchLayout(State);
 	}
-
-	if (Testing)
+	else if (State.RootNode >= 0)
 	{
-		return true;
+		NewRootSplitter = d->restoreNode(State, State.RootNode);
+	}
+	for (const auto& SideBar : State.SideBars)
+	{
+		d->restoreSideBar(SideBar);
 	}
 
-	// If the root splitter is empty, rostoreChildNodes returns a 0 pointer
+	// If the root splitter is empty, restoreNode returns a 0 pointer
 	// and we need to create a new empty root splitter
 	if (!NewRootSplitter)
 	{
 		NewRootSplitter = d->newSplitter(Qt::Horizontal);
 	}
 
+	if (NewRootSplitter == d->RootSplitter)
+	{
+		return;
+	}
+
 	QLayoutItem* li = d->Layout->replaceWidget(d->RootSplitter, NewRootSplitter);
 	auto OldRoot = d->RootSplitter;
 	d->RootSplitter = qobject_cast<CDockSplitter*>(NewRootSplitter);
 	OldRoot->deleteLater();
 	delete li;
-
-	return true;
 }
 
 
@@ -2235,7 +2530,7 @@ CDockWidget* CDockContainerWidget::topLevelDockWidget() const
 //============================================================================
 CDockAreaWidget* CDockContainerWidget::topLevelDockArea() const
 {
-	auto DockAreas = openedDockAreas();
+	const auto& DockAreas = d->openedDockAreas();
 	if (DockAreas.count() != 1)
 	{
 		return nullptr;
@@ -2271,6 +2566,7 @@ void CDockContainerWidget::updateSplitterHandles(QSplitter* splitter)
 void CDockContainerWidget::registerAutoHideWidget(CAutoHideDockContainer* AutohideWidget)
 {
 	d->AutoHideWidgets.append(AutohideWidget);
+	markStateDirty();
 	Q_EMIT autoHideWidgetCreated(AutohideWidget);
     ADS_PRINT("d->AutoHideWidgets.count() " << d->AutoHideWidgets.count());
 }
@@ -2279,6 +2575,61 @@ void CDockContainerWidget::registerAutoHideWidget(CAutoHideDockContainer* Autohi
 void CDockContainerWidget::removeAutoHideWidget(CAutoHideDockContainer* AutohideWidget)
 {
 	d->AutoHideWidgets.removeAll(AutohideWidget);
+	removeExpandedAutoHideWidget(AutohideWidget);
+	markStateDirty();
+}
+
+
+//============================================================================
+void CDockContainerWidget::markStateDirty()
+{
+	++d->StateGeneration;
+}
+
+
+//============================================================================
+quint64 CDockContainerWidget::stateGeneration() const
+{
+	return d->StateGeneration;
+}
+
+
+//============================================================================
+void CDockContainerWidget::updateStateCache(const DockContainerState& State)
+{
+	if (d->CachedStateGeneration == d->StateGeneration)
+	{
+		d->CachedState = State;
+	}
+}
+
+
+//============================================================================
+void CDockContainerWidget::clearStateCache()
+{
+	d->CachedState = DockContainerState();
+	d->CachedStateGeneration = 0;
+}
+
+
+//============================================================================
+void CDockContainerWidget::registerExpandedAutoHideWidget(CAutoHideDockContainer* AutohideWidget)
+{
+	if (!d->AutoHideEventDispatcher)
+	{
+		d->AutoHideEventDispatcher = new CAutoHideEventDispatcher(this);
+	}
+	d->AutoHideEventDispatcher->addWidget(AutohideWidget);
+}
+
+
+//============================================================================
+void CDockContainerWidget::removeExpandedAutoHideWidget(CAutoHideDockContainer* AutohideWidget)
+{
+	if (d->AutoHideEventDispatcher)
+	{
+		d->AutoHideEventDispatcher->removeWidget(AutohideWidget);
+	}
 }
 
 //============================================================================
@@ -2381,6 +2732,50 @@ CDockManager* CDockContainerWidget::dockManager() const
 }
 
 
+//============================================================================
+void CDockContainerWidget::applyDeferredLayoutUpdate()
+{
+	if (d->RootSplitter)
+	{
+		d->updateSplitterHandlesRecursive(d->RootSplitter);
+	}
+
+	for (const auto& DockArea : d->DockAreas)
+	{
+		if (DockArea)
+		{
+			DockArea->updateTitleBarVisibility();
+			DockArea->markTitleBarMenuOutdated();
+		}
+	}
+
+	if (d->DockAreasRemovedPending || d->DockAreasAddedPending)
+	{
+		d->onVisibleDockAreaCountChanged();
+	}
+
+	if (d->DockAreasRemovedPending)
+	{
+		d->DockAreasRemovedPending = false;
+		Q_EMIT dockAreasRemoved();
+	}
+
+	if (d->DockAreasAddedPending)
+	{
+		d->DockAreasAddedPending = false;
+		Q_EMIT dockAreasAdded();
+	}
+
+	// Emit the deferred topLevelChanged() signals. emitTopLevelChanged()
+	// only emits a signal if the top level state really changed
+	auto TopLevelDockWidget = topLevelDockWidget();
+	for (auto DockWidget : dockWidgets())
+	{
+		DockWidget->emitTopLevelChanged(DockWidget == TopLevelDockWidget);
+	}
+}
+
+
 //===========================================================================
 void CDockContainerWidget::handleAutoHideWidgetEvent(QEvent* e, QWidget* w)
 {
@@ -38,6 +38,7 @@
 #include "FloatingWidgetRestoreInfo.h"
 
 QT_FORWARD_DECLARE_CLASS(QXmlStreamWriter)
+QT_FORWARD_DECLARE_CLASS(QIODevice)
 
 
 namespace ads
@@ -52,11 +53,26 @@ struct FloatingDockContainerPrivate;
 class CFloatingDragPreview;
 struct FloatingDragPreviewPrivate;
 class CDockingStateReader;
+struct DockContainerState;
 class CAutoHideSideBar;
 class CAutoHideTab;
 class CDockSplitter;
 struct AutoHideTabPrivate;
 struct AutoHideDockContainerPrivate;
+struct DockHitTestIndexPrivate;
+
+
+/**
+ * Layout statistics of a dock container. The statistics are maintained
+ * incrementally by the container, so querying them does not scan the dock
+ * areas.
+ */
+struct DockLayoutStatistics
+{
+	int DockAreas = 0; ///< number of dock areas
+	int VisibleDockAreas = 0; ///< number of dock areas that are not hidden
+	CDockAreaWidget* TopLevelDockArea = nullptr; ///< the single visible dock area or nullptr
+};
 
 
 /**
@@ -86,6 +102,7 @@ private:
 	friend AutoHideTabPrivate;
 	friend AutoHideDockContainerPrivate;
 	friend CAutoHideSideBar;
+	friend struct DockHitTestIndexPrivate;
 
 protected:
 	/**
@@ -98,6 +115,19 @@ protected:
 	 */
 	CDockSplitter* rootSplitter() const;
 
+	/**
+	 * Dock areas call this function if they are shown or hidden to update
+	 * the layout statistics
+	 */
+	void updateDockAreaVisibility(CDockAreaWidget* DockArea);
+
+	/**
+	 * Applies the splitter handle, title bar, tabs menu and signal updates
+	 * that have been deferred while the dock manager was in a layout update
+	 * \see CDockManager::beginLayoutUpdate()
+	 */
+	void applyDeferredLayoutUpdate();
+
 	/**
 	 * Creates and initializes a dockwidget auto hide container into the given area.
 	 * Initializing inserts the tabs into the side tab widget and hides it
@@ -157,12 +187,16 @@ protected:
 	void saveState(QXmlStreamWriter& Stream) const;
 
 	/**
-	 * Restores the state from given stream.
-	 * If Testing is true, the function only parses the data from the given
-	 * stream but does not restore anything. You can use this check for
-	 * faulty files before you start restoring the state
+	 * Saves the state into the given container state tree
 	 */
-	bool restoreState(CDockingStateReader& Stream, bool Testing);
+	void saveState(DockContainerState& State) const;
+
+	/**
+	 * Restores the state from the given parsed container state.
+	 * The state has been validated by CDockingStateReader::readContainer()
+	 * so restoring can not fail anymore.
+	 */
+	void restoreState(const DockContainerState& State);
 
 	/**
 	 * This function returns the last added dock area widget for the given
@@ -211,12 +245,35 @@ protected:
 	 */
     void removeAutoHideWidget(CAutoHideDockContainer* AutoHideWidget);
 
+    /**
+     * Routes the application events that are relevant for an expanded auto
+     * hide widget to the given auto hide widget. All expanded auto hide
+     * widgets of this container share a single application event filter.
+     */
+    void registerExpandedAutoHideWidget(CAutoHideDockContainer* AutoHideWidget);
+
+    /**
+     * Stops routing application events to the given auto hide widget
+     */
+    void removeExpandedAutoHideWidget(CAutoHideDockContainer* AutoHideWidget);
+
     /**
      * Handles widget events of auto hide widgets to trigger delayed show
      * or hide actions for auto hide container on auto hide tab mouse over
      */
     void handleAutoHideWidgetEvent(QEvent* e, QWidget* w);
 
+	/**
+	 * Stores the given state with encoded XML fragment in the state cache
+	 * if the state has been captured for the current state generation
+	 */
+	void updateStateCache(const DockContainerState& State);
+
+	/**
+	 * Releases the cached state
+	 */
+	void clearStateCache();
+
 public:
 	/**
 	 * Default Constructor
@@ -280,7 +337,7 @@ public:
 	/**
 	 * This function returns true, if the container has open dock areas.
 	 * This functions is a little bit faster than calling openedDockAreas().isEmpty()
-	 * because it returns as soon as it finds an open dock area
+	 * because it only checks the maintained visible dock area count
 	 */
 	bool hasOpenDockAreas() const;
 
@@ -302,6 +359,12 @@ public:
 	 */
 	int visibleDockAreaCount() const;
 
+	/**
+	 * Returns the incrementally maintained layout statistics of this
+	 * container
+	 */
+	DockLayoutStatistics layoutStatistics() const;
+
 	/**
 	 * This function returns true, if this container is in a floating widget
 	 */
@@ -312,6 +375,33 @@ public:
 	 */
 	void dumpLayout();
 
+	/**
+	 * Streams the state of this container as standalone XML document with
+	 * a single Container element into the given device. The XML auto
+	 * formatting follows the XmlAutoFormattingEnabled config flag.
+	 * Returns false, if writing to the device failed.
+	 */
+	bool saveState(QIODevice* Device) const;
+
+	/**
+	 * Marks the layout of this container as changed since the last
+	 * saveState() call. Structural changes, resizing of dock areas and
+	 * splitters and toggling of dock widgets mark the container
+	 * automatically. Call this
+	 * function, if you change something that is stored in the state without
+	 * using the docking system API, for example the object name of a dock
+	 * widget.
+	 * \see CDockManager::setIncrementalSaveEnabled()
+	 */
+	void markStateDirty();
+
+	/**
+	 * Returns the state generation of this container. The generation is
+	 * incremented each time the layout of the container is marked as
+	 * changed.
+	 */
+	quint64 stateGeneration() const;
+
 	/**
 	 * This functions returns the dock widget features of all dock widget in
 	 * this container.
@@ -68,9 +68,17 @@ struct DockFocusControllerPrivate
 //===========================================================================
 static void updateDockWidgetFocusStyle(CDockWidget* DockWidget, bool Focused)
 {
+	// Only widgets whose focused property changes need to be repolished
+	auto TabWidget = DockWidget->tabWidget();
+	if (TabWidget->property("focused").toBool() == Focused
+	 && DockWidget->property("focused").toBool() == Focused)
+	{
+		return;
+	}
+
 	DockWidget->setProperty("focused", Focused);
-	DockWidget->tabWidget()->setProperty("focused", Focused);
-	DockWidget->tabWidget()->updateStyle();
+	TabWidget->setProperty("focused", Focused);
+	TabWidget->updateStyle();
 	internal::repolishStyle(DockWidget);
 }
 
@@ -78,6 +86,13 @@ static void updateDockWidgetFocusStyle(CDockWidget* DockWidget, bool Focused)
 //===========================================================================
 static void updateDockAreaFocusStyle(CDockAreaWidget* DockArea, bool Focused)
 {
+	// The title bar styles depend on the focused property of the dock area,
+	// so the title bar is repolished together with the area
+	if (DockArea->property("focused").toBool() == Focused)
+	{
+		return;
+	}
+
 	DockArea->setProperty("focused", Focused);
 	internal::repolishStyle(DockArea);
 	internal::repolishStyle(DockArea->titleBar());
@@ -133,7 +148,8 @@ void DockFocusControllerPrivate::updateDockWidgetFocus(CDockWidget* DockWidget)
         Window->setProperty(FocusedDockWidgetProperty, QVariant::fromValue(QPointer<CDockWidget>(DockWidget)));
 	}
 	CDockAreaWidget* NewFocusedDockArea = nullptr;
-	if (FocusedDockWidget)
+	// Refocusing the focused dock widget does not change its style
+	if (FocusedDockWidget && FocusedDockWidget != DockWidget)
 	{
 		updateDockWidgetFocusStyle(FocusedDockWidget, false);
 	}
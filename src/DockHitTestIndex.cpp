@@ -0,0 +1,498 @@
+//============================================================================
+/// \file   DockHitTestIndex.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Implementation of CDockHitTestIndex class
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockHitTestIndex.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include <QEvent>
+#include <QPointer>
+#include <QRect>
+#include <QSet>
+#include <QSplitter>
+#include <QVector>
+
+#include "DockManager.h"
+#include "DockContainerWidget.h"
+#include "DockAreaWidget.h"
+#include "DockSplitter.h"
+
+namespace ads
+{
+/**
+ * Splitter or dock area node of the splitter tree of an indexed container
+ */
+struct HitTestNode
+{
+	QRect Rect; ///< global rectangle
+	CDockAreaWidget* DockArea = nullptr; ///< nullptr for splitter nodes
+	Qt::Orientation Orientation = Qt::Horizontal;
+	int FirstChild = -1; ///< children are stored contiguously
+	int ChildCount = 0;
+};
+
+/**
+ * Indexed container with its splitter tree. Nodes[0] is the root splitter.
+ */
+struct HitTestContainer
+{
+	CDockContainerWidget* Container = nullptr;
+	QRect Rect;
+	QVector<HitTestNode> Nodes;
+};
+
+
+/**
+ * Private data class of CDockHitTestIndex class (pimpl)
+ */
+struct DockHitTestIndexPrivate
+{
+	CDockHitTestIndex* _this;
+	CDockManager* DockManager;
+	QPointer<CDockContainerWidget> DraggedContainer;
+	bool DragActive = false;
+	bool Dirty = true;
+	QVector<HitTestContainer> Containers; ///< ordered front to back
+	QSet<QObject*> WatchedObjects;
+	DockDragStatistics Statistics;
+
+	/**
+	 * Private data constructor
+	 */
+	DockHitTestIndexPrivate(CDockHitTestIndex *_public);
+
+	/**
+	 * Builds the index if it is dirty
+	 */
+	void ensureIndex();
+
+	/**
+	 * Releases all indexed data and removes the event filters
+	 */
+	void clear();
+
+	/**
+	 * Installs the event filter for geometry changes on the given object
+	 */
+	void watch(QObject* Object);
+
+	/**
+	 * Appends the visible child splitters and dock areas of the given
+	 * splitter node
+	 */
+	void addChildNodes(HitTestContainer& Entry, int NodeIndex, QSplitter* Splitter);
+
+	/**
+	 * Returns the indexed container entry or a nullptr
+	 */
+	const HitTestContainer* findContainer(const CDockContainerWidget* Container) const;
+
+	/**
+	 * Linear search for the front most container at the given global
+	 * position. Used outside of drag operations, where no index is built.
+	 */
+	CDockContainerWidget* searchContainer(const QPoint& GlobalPos) const;
+};
+// struct DockHitTestIndexPrivate
+
+
+//============================================================================
+static QRect globalRect(const QWidget* Widget)
+{
+	return QRect(Widget->mapToGlobal(QPoint(0, 0)), Widget->size());
+}
+
+
+//============================================================================
+DockHitTestIndexPrivate::DockHitTestIndexPrivate(CDockHitTestIndex *_public) :
+	_this(_public)
+{
+
+}
+
+
+//============================================================================
+void DockHitTestIndexPrivate::watch(QObject* Object)
+{
+	if (WatchedObjects.contains(Object))
+	{
+		return;
+	}
+
+	WatchedObjects.insert(Object);
+	Object->installEventFilter(_this);
+	QObject::connect(Object, &QObject::destroyed, _this, [this](QObject* Object)
+		{
+			WatchedObjects.remove(Object);
+			Dirty = true;
+		});
+}
+
+
+//============================================================================
+void DockHitTestIndexPrivate::clear()
+{
+	for (auto Object : WatchedObjects)
+	{
+		Object->removeEventFilter(_this);
+		QObject::disconnect(Object, nullptr, _this, nullptr);
+	}
+	WatchedObjects.clear();
+	Containers.clear();
+	Dirty = true;
+}
+
+
+//============================================================================
+void DockHitTestIndexPrivate::addChildNodes(HitTestContainer& Entry, int NodeIndex,
+	QSplitter* Splitter)
+{
+	QVector<QWidget*> Children;
+	Children.reserve(Splitter->count());
+	for (int i = 0; i < Splitter->count(); ++i)
+	{
+		auto Widget = Splitter->widget(i);
+		if (Widget->isVisible()
+		 && (qobject_cast<QSplitter*>(Widget) || qobject_cast<CDockAreaWidget*>(Widget)))
+		{
+			Children.append(Widget);
+		}
+	}
+
+	// Children are sorted by their position along the splitter axis to
+	// support the binary search - this also covers right to left layouts
+	QVector<QRect> Rects(Children.count());
+	for (int i = 0; i < Children.count(); ++i)
+	{
+		Rects[i] = globalRect(Children[i]);
+	}
+	QVector<int> Order(Children.count());
+	std::iota(Order.begin(), Order.end(), 0);
+	bool Horizontal = Splitter->orientation() == Qt::Horizontal;
+	std::sort(Order.begin(), Order.end(), [&Rects, Horizontal](int a, int b)
+		{
+			return Horizontal ? Rects[a].left() < Rects[b].left() : Rects[a].top() < Rects[b].top();
+		});
+
+	int FirstChild = Entry.Nodes.count();
+	Entry.Nodes[NodeIndex].FirstChild = FirstChild;
+	Entry.Nodes[NodeIndex].ChildCount = Children.count();
+	Entry.Nodes.resize(FirstChild + Children.count());
+	for (int i = 0; i < Order.count(); ++i)
+	{
+		auto Widget = Children[Order[i]];
+		auto& Node = Entry.Nodes[FirstChild + i];
+		Node.Rect = Rects[Order[i]];
+		Node.DockArea = qobject_cast<CDockAreaWidget*>(Widget);
+		watch(Widget);
+	}
+
+	for (int i = 0; i < Order.count(); ++i)
+	{
+		auto ChildSplitter = qobject_cast<QSplitter*>(Children[Order[i]]);
+		if (ChildSplitter)
+		{
+			Entry.Nodes[FirstChild + i].Orientation = ChildSplitter->orientation();
+			addChildNodes(Entry, FirstChild + i, ChildSplitter);
+		}
+	}
+}
+
+
+//============================================================================
+void DockHitTestIndexPrivate::ensureIndex()
+{
+	if (!Dirty)
+	{
+		return;
+	}
+
+	clear();
+	Dirty = false;
+	Statistics.IndexBuilds++;
+	for (auto Container : DockManager->dockContainers())
+	{
+		if (!Container->isVisible() || Container == DraggedContainer)
+		{
+			continue;
+		}
+
+		HitTestContainer Entry;
+		Entry.Container = Container;
+		Entry.Rect = globalRect(Container);
+		watch(Container);
+		watch(Container->window());
+		auto RootSplitter = Container->rootSplitter();
+		if (RootSplitter && RootSplitter->isVisible())
+		{
+			HitTestNode Root;
+			Root.Rect = globalRect(RootSplitter);
+			Root.Orientation = RootSplitter->orientation();
+			Entry.Nodes.append(Root);
+			watch(RootSplitter);
+			addChildNodes(Entry, 0, RootSplitter);
+		}
+		Containers.append(Entry);
+	}
+
+	// Front most containers first - stable sort keeps the order of the
+	// dock manager for equal z-order indices like the linear search did
+	std::stable_sort(Containers.begin(), Containers.end(),
+		[](const HitTestContainer& a, const HitTestContainer& b)
+		{
+			return a.Container->isInFrontOf(b.Container);
+		});
+}
+
+
+//============================================================================
+const HitTestContainer* DockHitTestIndexPrivate::findContainer(
+	const CDockContainerWidget* Container) const
+{
+	for (const auto& Entry : Containers)
+	{
+		if (Entry.Container == Container)
+		{
+			return &Entry;
+		}
+	}
+
+	return nullptr;
+}
+
+
+//============================================================================
+CDockContainerWidget* DockHitTestIndexPrivate::searchContainer(const QPoint& GlobalPos) const
+{
+	CDockContainerWidget* TopContainer = nullptr;
+	for (auto Container : DockManager->dockContainers())
+	{
+		if (!Container->isVisible() || Container == DraggedContainer)
+		{
+			continue;
+		}
+
+		QPoint MappedPos = Container->mapFromGlobal(GlobalPos);
+		if (Container->rect().contains(MappedPos)
+		 && (!TopContainer || Container->isInFrontOf(TopContainer)))
+		{
+			TopContainer = Container;
+		}
+	}
+
+	return TopContainer;
+}
+
+
+//============================================================================
+CDockHitTestIndex::CDockHitTestIndex(CDockManager* DockManager) :
+	Super(DockManager),
+	d(new DockHitTestIndexPrivate(this))
+{
+	d->DockManager = DockManager;
+}
+
+
+//============================================================================
+CDockHitTestIndex::~CDockHitTestIndex()
+{
+	d->clear();
+	delete d;
+}
+
+
+//============================================================================
+void CDockHitTestIndex::beginDrag(CDockContainerWidget* DraggedContainer)
+{
+	d->clear();
+	d->DraggedContainer = DraggedContainer;
+	d->DragActive = true;
+	d->Statistics = DockDragStatistics();
+}
+
+
+//============================================================================
+void CDockHitTestIndex::endDrag()
+{
+	if (!d->DragActive)
+	{
+		return;
+	}
+
+	d->clear();
+	d->DraggedContainer = nullptr;
+	d->DragActive = false;
+	ADS_PRINT("CDockHitTestIndex::endDrag frames: " << d->Statistics.Frames
+		<< " avg ns: " << d->Statistics.averageNs()
+		<< " max ns: " << d->Statistics.MaxNs
+		<< " index builds: " << d->Statistics.IndexBuilds
+		<< " overlay repaints: " << d->Statistics.OverlayRepaints);
+}
+
+
+//============================================================================
+bool CDockHitTestIndex::isDragActive() const
+{
+	return d->DragActive;
+}
+
+
+//============================================================================
+void CDockHitTestIndex::invalidate()
+{
+	d->Dirty = true;
+}
+
+
+//============================================================================
+bool CDockHitTestIndex::eventFilter(QObject* watched, QEvent* event)
+{
+	switch (event->type())
+	{
+	case QEvent::Move:
+	case QEvent::Resize:
+	case QEvent::Show:
+	case QEvent::Hide:
+	case QEvent::ChildAdded:
+	case QEvent::ChildRemoved:
+	case QEvent::ParentChange:
+	case QEvent::WindowActivate:
+	case QEvent::ZOrderChange:
+		d->Dirty = true;
+		break;
+
+	default:
+		break;
+	}
+
+	return Super::eventFilter(watched, event);
+}
+
+
+//============================================================================
+CDockContainerWidget* CDockHitTestIndex::containerAt(const QPoint& GlobalPos)
+{
+	// The index and its event filters only live during a drag operation
+	if (!d->DragActive)
+	{
+		return d->searchContainer(GlobalPos);
+	}
+
+	d->ensureIndex();
+	for (const auto& Entry : d->Containers)
+	{
+		if (Entry.Rect.contains(GlobalPos))
+		{
+			return Entry.Container;
+		}
+	}
+
+	return nullptr;
+}
+
+
+//============================================================================
+bool CDockHitTestIndex::isIndexed(const CDockContainerWidget* Container)
+{
+	if (!d->DragActive)
+	{
+		return false;
+	}
+
+	d->ensureIndex();
+	return d->findContainer(Container) != nullptr;
+}
+
+
+//============================================================================
+CDockAreaWidget* CDockHitTestIndex::dockAreaAt(const CDockContainerWidget* Container,
+	const QPoint& GlobalPos)
+{
+	if (!d->DragActive)
+	{
+		return Container->dockAreaAt(GlobalPos);
+	}
+
+	d->ensureIndex();
+	auto Entry = d->findContainer(Container);
+	if (!Entry || Entry->Nodes.isEmpty())
+	{
+		return nullptr;
+	}
+
+	const auto& Nodes = Entry->Nodes;
+	int Index = 0;
+	while (true)
+	{
+		const auto& Node = Nodes[Index];
+		if (!Node.Rect.contains(GlobalPos))
+		{
+			return nullptr;
+		}
+
+		if (Node.DockArea)
+		{
+			return Node.DockArea;
+		}
+
+		if (Node.ChildCount < 1)
+		{
+			return nullptr;
+		}
+
+		// Find the last child that starts before the position along the
+		// splitter axis
+		bool Horizontal = (Node.Orientation == Qt::Horizontal);
+		int Pos = Horizontal ? GlobalPos.x() : GlobalPos.y();
+		auto First = Nodes.constBegin() + Node.FirstChild;
+		auto Last = First + Node.ChildCount;
+		auto it = std::upper_bound(First, Last, Pos,
+			[Horizontal](int Pos, const HitTestNode& Child)
+			{
+				return Pos < (Horizontal ? Child.Rect.left() : Child.Rect.top());
+			});
+		if (it == First)
+		{
+			return nullptr;
+		}
+		Index = int(std::distance(Nodes.constBegin(), it - 1));
+	}
+}
+
+
+//============================================================================
+void CDockHitTestIndex::recordFrame(qint64 Nanoseconds)
+{
+	d->Statistics.Frames++;
+	d->Statistics.TotalNs += Nanoseconds;
+	d->Statistics.MaxNs = qMax(d->Statistics.MaxNs, Nanoseconds);
+}
+
+
+//============================================================================
+void CDockHitTestIndex::recordOverlayRepaint()
+{
+	if (d->DragActive)
+	{
+		d->Statistics.OverlayRepaints++;
+	}
+}
+
+
+//============================================================================
+DockDragStatistics CDockHitTestIndex::statistics() const
+{
+	return d->Statistics;
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockHitTestIndex.cpp
@@ -0,0 +1,157 @@
+#ifndef DockHitTestIndexH
+#define DockHitTestIndexH
+//============================================================================
+/// \file   DockHitTestIndex.h
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Declaration of CDockHitTestIndex class
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QObject>
+#include <QElapsedTimer>
+#include <QPoint>
+
+#include "ads_globals.h"
+
+namespace ads
+{
+struct DockHitTestIndexPrivate;
+class CDockManager;
+class CDockContainerWidget;
+class CDockAreaWidget;
+
+/**
+ * Drag frame latency statistics of the last or the current drag operation
+ */
+struct DockDragStatistics
+{
+	int Frames = 0; ///< number of drop overlay updates
+	qint64 TotalNs = 0; ///< accumulated time of all drop overlay updates
+	qint64 MaxNs = 0; ///< time of the slowest drop overlay update
+	int IndexBuilds = 0; ///< number of times the hit test index was built
+	int OverlayRepaints = 0; ///< number of drop overlay repaints
+
+	/**
+	 * Average time of a drop overlay update in nanoseconds
+	 */
+	qint64 averageNs() const {return Frames ? TotalNs / Frames : 0;}
+};
+
+/**
+ * Spatial index for the drop target lookup during drag operations.
+ * The index stores the global rectangles of all visible dock containers
+ * ordered by their z-order and for each container the tree of its visible
+ * splitters and dock areas. The index is built lazily on the first lookup
+ * after the drag started and it is invalidated if the geometry of any
+ * indexed widget changes. A lookup descends the splitter tree with a binary
+ * search over the children of each splitter, so it does not need to test
+ * every dock area. Outside of drag operations the lookups fall back to a
+ * linear search and no index is built.
+ */
+class ADS_EXPORT CDockHitTestIndex : public QObject
+{
+	Q_OBJECT
+private:
+	DockHitTestIndexPrivate* d; ///< private data (pimpl)
+	friend struct DockHitTestIndexPrivate;
+
+protected:
+	virtual bool eventFilter(QObject* watched, QEvent* event) override;
+
+public:
+	using Super = QObject;
+
+	/**
+	 * Measures the duration of one drag frame and records it in the given
+	 * index when it goes out of scope
+	 */
+	class FrameTimer
+	{
+	private:
+		CDockHitTestIndex* m_Index;
+		QElapsedTimer m_Timer;
+
+	public:
+		FrameTimer(CDockHitTestIndex* Index) : m_Index(Index) {m_Timer.start();}
+		~FrameTimer()
+		{
+			if (m_Index)
+			{
+				m_Index->recordFrame(m_Timer.nsecsElapsed());
+			}
+		}
+	};
+
+	/**
+	 * Default Constructor
+	 */
+	CDockHitTestIndex(CDockManager* DockManager);
+
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~CDockHitTestIndex();
+
+	/**
+	 * Starts a drag operation and resets the drag statistics.
+	 * The given container is the dragged container that is never a drop
+	 * target. It is not indexed, so moving it does not invalidate the index.
+	 */
+	void beginDrag(CDockContainerWidget* DraggedContainer = nullptr);
+
+	/**
+	 * Ends the drag operation and releases the index
+	 */
+	void endDrag();
+
+	/**
+	 * Returns true, while a drag operation is active
+	 */
+	bool isDragActive() const;
+
+	/**
+	 * Marks the index as dirty. It is rebuilt on the next lookup.
+	 */
+	void invalidate();
+
+	/**
+	 * Returns the front most visible container at the given global position
+	 * or a nullptr, if there is no container
+	 */
+	CDockContainerWidget* containerAt(const QPoint& GlobalPos);
+
+	/**
+	 * Returns true, if the given container is part of the index
+	 */
+	bool isIndexed(const CDockContainerWidget* Container);
+
+	/**
+	 * Returns the visible dock area of the given container at the given
+	 * global position or a nullptr, if there is no dock area
+	 */
+	CDockAreaWidget* dockAreaAt(const CDockContainerWidget* Container,
+		const QPoint& GlobalPos);
+
+	/**
+	 * Records the duration of one drag frame
+	 */
+	void recordFrame(qint64 Nanoseconds);
+
+	/**
+	 * Records one repaint of a drop overlay during the current drag operation
+	 */
+	void recordOverlayRepaint();
+
+	/**
+	 * Returns the drag frame statistics of the current or the last drag
+	 * operation
+	 */
+	DockDragStatistics statistics() const;
+}; // class CDockHitTestIndex
+} // namespace ads
+
+//---------------------------------------------------------------------------
+#endif // DockHitTestIndexH
@@ -33,11 +33,14 @@
 #include "DockManager.h"
 
 #include <algorithm>
+#include <functional>
+#include <iterator>
 #include <iostream>
 
 #include <QMainWindow>
 #include <QList>
 #include <QMap>
+#include <QHash>
 #include <QVariant>
 #include <QDebug>
 #include <QFile>
@@ -49,6 +52,11 @@
 #include <QWindow>
 #include <QWindowStateChangeEvent>
 #include <QVector>
+#include <QTimer>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QFutureInterface>
+#include <QBuffer>
 
 #include "FloatingDockContainer.h"
 #include "DockOverlay.h"
@@ -57,10 +65,19 @@
 #include "DockAreaWidget.h"
 #include "IconProvider.h"
 #include "DockingStateReader.h"
+#include "DockingStateBinary.h"
+#include "DockingStateWriter.h"
 #include "DockAreaTitleBar.h"
+#include "DockAreaTabBar.h"
 #include "DockFocusController.h"
 #include "DockSplitter.h"
 #include "DockComponentsFactory.h"
+#include "DockHitTestIndex.h"
+#include "DragPreviewCache.h"
+#include "DockTrace.h"
+#include "PerspectiveStore.h"
+#include "DockingStateDelta.h"
+#include "CompressionDevice.h"
 
 
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
@@ -101,6 +118,150 @@ static QVector<QVariant> StaticConfigParams(CDockManager::ConfigParamCount);
 
 static QString FloatingContainersTitle;
 
+
+//============================================================================
+/**
+ * Encodes the given state tree with the given config flags. This function
+ * does not access any widget, so it can run in a worker thread.
+ */
+static QByteArray encodeDockingState(const DockingState& State,
+	CDockManager::eStateFormat Format, CDockManager::ConfigFlags Flags)
+{
+	ADS_TRACE_SCOPE_CATEGORY("encodeState", "state");
+	if (CDockManager::BinaryStateFormat == Format)
+	{
+		return CDockingStateBinary::write(State);
+	}
+
+	auto Xml = CDockingStateWriter::writeXml(State,
+		Flags.testFlag(CDockManager::XmlAutoFormattingEnabled));
+	return Flags.testFlag(CDockManager::XmlCompressionEnabled)
+		? qCompress(Xml, 9) : Xml;
+}
+
+
+//============================================================================
+static bool writeDockingState(const DockingState& State, QIODevice* Device,
+	CDockManager::eStateFormat Format, CDockManager::ConfigFlags Flags)
+{
+	ADS_TRACE_SCOPE_CATEGORY("writeState", "state");
+	if (CDockManager::BinaryStateFormat == Format)
+	{
+		auto Data = CDockingStateBinary::write(State);
+		return Device->write(Data) == Data.size();
+	}
+
+	bool AutoFormatting = Flags.testFlag(CDockManager::XmlAutoFormattingEnabled);
+	if (!Flags.testFlag(CDockManager::XmlCompressionEnabled))
+	{
+		return CDockingStateWriter::writeXml(State, Device, AutoFormatting);
+	}
+
+	CDeflateDevice Deflater(Device, 9);
+	if (!Deflater.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+	bool Result = CDockingStateWriter::writeXml(State, &Deflater, AutoFormatting);
+	Deflater.close();
+	return Result && Deflater.isValid();
+}
+
+
+/**
+ * Encodes a captured state in a worker thread and reports the encoded
+ * data to a future
+ */
+class CStateEncodeTask : public QRunnable
+{
+public:
+	QFutureInterface<QByteArray> Promise;
+	DockingState State;
+	CDockManager::eStateFormat Format;
+	CDockManager::ConfigFlags Flags;
+
+	CStateEncodeTask(const DockingState& State, CDockManager::eStateFormat Format,
+		CDockManager::ConfigFlags Flags)
+		: State(State), Format(Format), Flags(Flags)
+	{
+		Promise.reportStarted();
+	}
+
+	virtual void run() override
+	{
+		auto Data = encodeDockingState(State, Format, Flags);
+		Promise.reportResult(Data);
+		Promise.reportFinished();
+	}
+};
+
+/**
+ * Registry of the dock widgets of a dock manager.
+ * The registry provides hashed lookup by object name and by the handle of
+ * a dock widget and keeps the registered dock widgets in a vector for
+ * iteration.
+ */
+struct DockWidgetRegistry
+{
+	QVector<CDockWidget*> DockWidgets;
+	QHash<QString, CDockWidget*> ByName;
+	QHash<int, CDockWidget*> ByHandle;
+
+	/**
+	 * Registers the given dock widget with its current object name.
+	 * A different dock widget with the same name is replaced.
+	 */
+	void insert(CDockWidget* DockWidget)
+	{
+		auto Name = DockWidget->objectName();
+		auto Existing = ByName.value(Name);
+		if (Existing == DockWidget)
+		{
+			return;
+		}
+
+		if (Existing)
+		{
+			remove(Existing);
+		}
+
+		if (ByHandle.contains(DockWidget->handle()))
+		{
+			// The dock widget has been renamed since its registration
+			ByName.remove(ByName.key(DockWidget));
+		}
+		else
+		{
+			ByHandle.insert(DockWidget->handle(), DockWidget);
+			DockWidgets.append(DockWidget);
+		}
+		ByName.insert(Name, DockWidget);
+	}
+
+	/**
+	 * Removes the given dock widget from the registry
+	 */
+	void remove(CDockWidget* DockWidget)
+	{
+		if (!ByHandle.remove(DockWidget->handle()))
+		{
+			return;
+		}
+
+		auto Name = DockWidget->objectName();
+		if (ByName.value(Name) == DockWidget)
+		{
+			ByName.remove(Name);
+		}
+		else
+		{
+			ByName.remove(ByName.key(DockWidget));
+		}
+		DockWidgets.removeOne(DockWidget);
+	}
+};
+
+
 /**
  * Private data class of CDockManager class (pimpl)
  */
@@ -112,8 +273,9 @@ struct DockManagerPrivate
 	QList<CDockContainerWidget*> Containers;
 	CDockOverlay* ContainerOverlay;
 	CDockOverlay* DockAreaOverlay;
-	QMap<QString, CDockWidget*> DockWidgetsMap;
-	QMap<QString, QByteArray> Perspectives;
+	DockWidgetRegistry DockWidgets;
+	QSharedPointer<IPerspectiveStore> PerspectiveStore {new CMemoryPerspectiveStore()};
+	QThreadPool StateEncoderPool;
 	QMap<QString, QMenu*> ViewMenuGroups;
 	QMenu* ViewMenu;
 	CDockManager::eViewMenuInsertionOrder MenuInsertionOrder = CDockManager::MenuAlphabeticallySorted;
@@ -128,6 +290,18 @@ struct DockManagerPrivate
 	QSize ToolBarIconSizeFloating = QSize(24, 24);
 	CDockWidget::DockWidgetFeatures LockedDockWidgetFeatures;
 	bool DockingOnDragEnabled = true;
+	bool IncrementalRestoreEnabled = false;
+	bool IncrementalSaveEnabled = false;
+	int LayoutUpdateDepth = 0;
+	CDockHitTestIndex* HitTestIndex = nullptr;
+	CDragPreviewCache* DragPreviewCache = nullptr;
+	QTimer* ContentIdleTimer = nullptr;
+	int ContentIdleTimeout = 0;
+	int ContentBudget = 0;
+	int TabBarVirtualizationThreshold = 0;
+	bool PerspectiveDeltaEncoding = false;
+	QString BasePerspective;
+	bool BasePerspectiveValid = false;
 	QSharedPointer<ads::CDockComponentsFactory> ComponentFactory {ads::CDockComponentsFactory::factory()};
 
 	/**
@@ -136,20 +310,45 @@ struct DockManagerPrivate
 	DockManagerPrivate(CDockManager* _public);
 
 	/**
-	 * Checks if the given data stream is a valid docking system state
-	 * file.
+	 * Parses the XML, compressed XML or binary state from the given device
+	 * in a single pass into the given state tree and validates it. Returns
+	 * false if the state is not a valid docking system state for the given
+	 * version.
+	 */
+	bool readState(QIODevice* Device, int version, DockingState& State);
+
+	/**
+	 * Parses the XML state from the given device into the given state tree
+	 */
+	bool readXmlState(QIODevice* Device, int version, DockingState& State);
+
+	/**
+	 * Creates the dock containers from the given validated state tree
 	 */
-	bool checkFormat(const QByteArray &state, int version);
+	void restoreContainers(const DockingState& State);
 
 	/**
-	 * Restores the state
+	 * Validates the given state tree against the central widget of this
+	 * dock manager
 	 */
-	bool restoreStateFromXml(const QByteArray &state, int version, bool Testing = internal::Restore);
+	bool checkState(const DockingState& State) const;
 
 	/**
-	 * Restore state
+	 * Restores the layout from the given validated state tree
 	 */
-	bool restoreState(const QByteArray &state, int version);
+	bool restoreState(const DockingState& StateTree);
+
+	/**
+	 * Runs the given restore function with hidden dock manager and emits
+	 * the restoringState() and stateRestored() signals
+	 */
+	bool runRestore(const std::function<bool()>& Restore);
+
+	/**
+	 * Encodes the XML fragments of all containers of the given state that
+	 * have no cached fragment and stores them in the container state caches
+	 */
+	void cacheXmlFragments(DockingState& State);
 
 	void restoreDockWidgetsOpenState();
 	void restoreDockAreasIndices();
@@ -169,7 +368,7 @@ struct DockManagerPrivate
 
 	void markDockWidgetsDirty()
 	{
-		for (auto DockWidget : DockWidgetsMap)
+		for (auto DockWidget : DockWidgets.DockWidgets)
 		{
 			DockWidget->setProperty(internal::DirtyProperty, true);
 		}
@@ -178,7 +377,7 @@ struct DockManagerPrivate
 	/**
 	 * Restores the container with the given index
 	 */
-	bool restoreContainer(int Index, CDockingStateReader& stream, bool Testing);
+	void restoreContainer(int Index, const DockContainerState& State);
 
 	/**
 	 * Loads the stylesheet
@@ -189,6 +388,44 @@ struct DockManagerPrivate
 	 * Adds action to menu - optionally in sorted order
 	 */
 	void addActionToMenu(QAction* Action, QMenu* Menu, bool InsertSorted);
+
+	/**
+	 * Returns the name of the base perspective of the delta encoded
+	 * perspectives or an empty string if there is no base perspective
+	 */
+	QString basePerspective();
+
+	/**
+	 * Returns the decoded state of the perspective with the given name
+	 */
+	QByteArray perspectiveState(const QString& Name) const;
+
+	/**
+	 * Returns the decoded states of all perspectives that are delta encoded
+	 * against the given base perspective
+	 */
+	QMap<QString, QByteArray> dependentPerspectives(const QString& Base) const;
+
+	/**
+	 * Stores the given state as delta against the base perspective if delta
+	 * encoding is enabled and if the delta is smaller than the state
+	 */
+	void storeEncodedPerspective(const QString& Name, const QByteArray& State,
+		const QByteArray& BaseState);
+
+	/**
+	 * Stores the given perspective. If the perspective is the base of
+	 * delta encoded perspectives, the dependent perspectives are encoded
+	 * against the new state.
+	 */
+	void storePerspective(const QString& Name, const QByteArray& State);
+
+	/**
+	 * Removes the given perspective. If the perspective is the base of delta
+	 * encoded perspectives, the first dependent perspective becomes the new
+	 * base.
+	 */
+	bool removePerspective(const QString& Name);
 };
 // struct DockManagerPrivate
 
@@ -196,7 +433,166 @@ struct DockManagerPrivate
 DockManagerPrivate::DockManagerPrivate(CDockManager* _public) :
 	_this(_public)
 {
+	// A single thread keeps the encoded states in the order of the
+	// saveStateAsync() calls
+	StateEncoderPool.setMaxThreadCount(1);
+}
 
+
+//============================================================================
+QString DockManagerPrivate::basePerspective()
+{
+	if (!BasePerspectiveValid)
+	{
+		// All delta encoded perspectives share the same base, so we only
+		// need to read the first delta. The store knows the encoding from
+		// its index, so no perspective is read if there are no deltas
+		BasePerspective.clear();
+		const auto Names = PerspectiveStore->perspectiveNames();
+		for (const auto& Name : Names)
+		{
+			if (!PerspectiveStore->isDeltaEncoded(Name))
+			{
+				continue;
+			}
+
+			BasePerspective = CDockingStateDelta::baseName(PerspectiveStore->perspective(Name));
+			if (!BasePerspective.isEmpty())
+			{
+				break;
+			}
+		}
+		BasePerspectiveValid = true;
+	}
+
+	return BasePerspective;
+}
+
+
+//============================================================================
+QByteArray DockManagerPrivate::perspectiveState(const QString& Name) const
+{
+	auto Data = PerspectiveStore->perspective(Name);
+	if (!CDockingStateDelta::isDelta(Data))
+	{
+		return Data;
+	}
+
+	auto BaseState = PerspectiveStore->perspective(CDockingStateDelta::baseName(Data));
+	return CDockingStateDelta::decode(BaseState, Data);
+}
+
+
+//============================================================================
+QMap<QString, QByteArray> DockManagerPrivate::dependentPerspectives(const QString& Base) const
+{
+	QMap<QString, QByteArray> Dependents;
+	auto BaseState = PerspectiveStore->perspective(Base);
+	const auto Names = PerspectiveStore->perspectiveNames();
+	for (const auto& Name : Names)
+	{
+		if (!PerspectiveStore->isDeltaEncoded(Name))
+		{
+			continue;
+		}
+
+		auto Data = PerspectiveStore->perspective(Name);
+		if (CDockingStateDelta::baseName(Data) != Base)
+		{
+			continue;
+		}
+
+		auto State = CDockingStateDelta::decode(BaseState, Data);
+		if (!State.isEmpty())
+		{
+			Dependents.insert(Name, State);
+		}
+	}
+	return Dependents;
+}
+
+
+//============================================================================
+void DockManagerPrivate::storeEncodedPerspective(const QString& Name,
+	const QByteArray& State, const QByteArray& BaseState)
+{
+	if (PerspectiveDeltaEncoding && !BasePerspective.isEmpty()
+	 && Name != BasePerspective && !BaseState.isEmpty())
+	{
+		auto Delta = CDockingStateDelta::encode(BasePerspective, BaseState, State);
+		if (Delta.size() < State.size())
+		{
+			PerspectiveStore->setPerspective(Name, Delta);
+			return;
+		}
+	}
+
+	PerspectiveStore->setPerspective(Name, State);
+}
+
+
+//============================================================================
+void DockManagerPrivate::storePerspective(const QString& Name, const QByteArray& State)
+{
+	QMap<QString, QByteArray> Dependents;
+	if (PerspectiveStore->contains(Name) && Name == basePerspective())
+	{
+		Dependents = dependentPerspectives(Name);
+		BasePerspective.clear();
+	}
+
+	if (PerspectiveDeltaEncoding && basePerspective().isEmpty())
+	{
+		BasePerspective = Name;
+	}
+
+	// The base perspective itself is never delta encoded
+	auto BaseState = (BasePerspective.isEmpty() || BasePerspective == Name)
+		? State : PerspectiveStore->perspective(BasePerspective);
+	if (CDockingStateDelta::isDelta(BaseState))
+	{
+		BaseState.clear();
+	}
+	storeEncodedPerspective(Name, State, BaseState);
+	for (auto it = Dependents.constBegin(); it != Dependents.constEnd(); ++it)
+	{
+		storeEncodedPerspective(it.key(), it.value(), BaseState);
+	}
+}
+
+
+//============================================================================
+bool DockManagerPrivate::removePerspective(const QString& Name)
+{
+	QMap<QString, QByteArray> Dependents;
+	if (PerspectiveStore->contains(Name) && Name == basePerspective())
+	{
+		Dependents = dependentPerspectives(Name);
+		BasePerspective.clear();
+	}
+
+	if (!PerspectiveStore->removePerspective(Name))
+	{
+		return false;
+	}
+
+	if (Dependents.isEmpty())
+	{
+		return true;
+	}
+
+	// The first dependent perspective becomes the new base
+	auto Base = Dependents.constBegin();
+	if (PerspectiveDeltaEncoding)
+	{
+		BasePerspective = Base.key();
+	}
+	PerspectiveStore->setPerspective(Base.key(), Base.value());
+	for (auto it = std::next(Base); it != Dependents.constEnd(); ++it)
+	{
+		storeEncodedPerspective(it.key(), it.value(), Base.value());
+	}
+	return true;
 }
 
 
@@ -234,18 +630,12 @@ void DockManagerPrivate::loadStylesheet()
 
 
 //============================================================================
-bool DockManagerPrivate::restoreContainer(int Index, CDockingStateReader& stream, bool Testing)
+void DockManagerPrivate::restoreContainer(int Index, const DockContainerState& State)
 {
-	if (Testing)
-	{
-		Index = 0;
-	}
-
-	bool Result = false;
 	if (Index >= Containers.count())
 	{
 		CFloatingDockContainer* FloatingWidget = new CFloatingDockContainer(_this);
-		Result = FloatingWidget->restoreState(stream, Testing);
+		FloatingWidget->restoreState(State);
 	}
 	else
 	{
@@ -253,36 +643,93 @@ bool DockManagerPrivate::restoreContainer(int Index, CDockingStateReader& stream
 		auto Container = Containers[Index];
 		if (Container->isFloating())
 		{
-			Result = Container->floatingWidget()->restoreState(stream, Testing);
+			Container->floatingWidget()->restoreState(State);
 		}
 		else
 		{
-			Result = Container->restoreState(stream, Testing);
+			Container->restoreState(State);
 		}
 	}
-
-	return Result;
 }
 
 
 //============================================================================
-bool DockManagerPrivate::checkFormat(const QByteArray &state, int version)
-{
-    return restoreStateFromXml(state, version, internal::RestoreTesting);
+bool DockManagerPrivate::readState(QIODevice* Device, int version,
+	DockingState& State)
+{
+	ADS_TRACE_SCOPE_CATEGORY("readState", "restore");
+	// The header is large enough to detect the XML declaration and the
+	// binary format magic
+	const int HeaderSize = 8;
+	auto Header = Device->peek(HeaderSize);
+    if (Header.isEmpty())
+    {
+        return false;
+    }
+
+    // Everything that is neither XML nor binary is compressed data that
+    // is inflated while it is parsed
+    QScopedPointer<CInflateDevice> Inflater;
+    if (!Header.startsWith("<?xml") && !CDockingStateBinary::isBinary(Header))
+    {
+    	Inflater.reset(new CInflateDevice(Device));
+    	if (!Inflater->open(QIODevice::ReadOnly))
+    	{
+    		return false;
+    	}
+    	Device = Inflater.data();
+    	Header = Device->peek(HeaderSize);
+    }
+
+    if (CDockingStateBinary::isBinary(Header))
+    {
+    	if (!CDockingStateBinary::read(Device->readAll(), State)
+    	 || State.FileVersion > CurrentVersion
+    	 || State.UserVersion != version)
+    	{
+    		return false;
+    	}
+    }
+    else if (!readXmlState(Device, version, State))
+    {
+    	return false;
+    }
+
+    return checkState(State);
 }
 
 
 //============================================================================
-bool DockManagerPrivate::restoreStateFromXml(const QByteArray &state,  int version,
-	bool Testing)
+bool DockManagerPrivate::checkState(const DockingState& State) const
 {
-	Q_UNUSED(version);
-
-    if (state.isEmpty())
+    if (CentralWidget && !CDockManager::testConfigFlag(CDockManager::PerspectivesWithOutCentralWidget))
     {
-        return false;
+		// If we have a central widget but a state without central widget, then
+		// something is wrong.
+		if (State.CentralWidget.isEmpty())
+		{
+			qWarning() << "Dock manager has central widget but saved state does not have central widget.";
+			return false;
+		}
+
+		// If the object name of the central widget does not match the name of the
+		// saved central widget, the something is wrong
+		if (CentralWidget->objectName() != State.CentralWidget)
+		{
+			qWarning() << "Object name of central widget does not match name of central widget in saved state.";
+			return false;
+		}
     }
-    CDockingStateReader s(state);
+
+    return true;
+}
+
+
+//============================================================================
+bool DockManagerPrivate::readXmlState(QIODevice* Device, int version,
+	DockingState& State)
+{
+    CDockingStateReader s(Device);
     s.readNextStartElement();
     if (s.name() != QLatin1String("QtAdvancedDockingSystem"))
     {
@@ -296,6 +743,7 @@ bool DockManagerPrivate::restoreStateFromXml(const QByteArray &state,  int versi
     	return false;
     }
     s.setFileVersion(v);
+    State.FileVersion = v;
 
     ADS_PRINT(s.attributes().value("UserVersion"));
     // Older files do not support UserVersion but we still want to load them so
@@ -307,73 +755,70 @@ bool DockManagerPrivate::restoreStateFromXml(const QByteArray &state,  int versi
 		{
 			return false;
 		}
+		State.UserVersion = v;
     }
 
-    bool Result = true;
 #ifdef ADS_DEBUG_PRINT
     int  DockContainers = s.attributes().value("Containers").toInt();
 #endif
     ADS_PRINT(DockContainers);
 
-    if (CentralWidget && !CDockManager::testConfigFlag(CDockManager::PerspectivesWithOutCentralWidget))
-    {
-		const auto CentralWidgetAttribute = s.attributes().value("CentralWidget");
-		// If we have a central widget but a state without central widget, then
-		// something is wrong.
-		if (CentralWidgetAttribute.isEmpty())
-		{
-			qWarning() << "Dock manager has central widget but saved state does not have central widget.";
-			return false;
-		}
+    State.CentralWidget = s.attributes().value("CentralWidget").toString();
 
-		// If the object name of the central widget does not match the name of the
-		// saved central widget, the something is wrong
-		if (CentralWidget->objectName() != CentralWidgetAttribute.toString())
-		{
-			qWarning() << "Object name of central widget does not match name of central widget in saved state.";
-			return false;
-		}
-    }
-
-    int DockContainerCount = 0;
     while (s.readNextStartElement())
     {
         if (s.name() == QLatin1String("Container"))
     	{
-    		Result = restoreContainer(DockContainerCount, s, Testing);
-			if (!Result)
-			{
-				break;
-			}
-			DockContainerCount++;
+        	DockContainerState Container;
+        	if (!s.readContainer(Container))
+        	{
+        		return false;
+        	}
+        	State.Containers.append(Container);
     	}
+        else
+        {
+        	s.skipCurrentElement();
+        }
     }
 
-    if (!Testing)
-    {
-		// Delete remaining empty floating widgets
-		int FloatingWidgetIndex = DockContainerCount - 1;
-		for (int i = FloatingWidgetIndex; i < FloatingWidgets.count(); ++i)
-		{
-			CFloatingDockContainer* floatingWidget = FloatingWidgets[i];
-			if (!floatingWidget) continue;
-			_this->removeDockContainer(floatingWidget->dockContainer());
-			floatingWidget->deleteLater();
-		}
-    }
+    return !s.hasError();
+}
+
 
-    return Result;
+//============================================================================
+void DockManagerPrivate::restoreContainers(const DockingState& State)
+{
+	ADS_TRACE_SCOPE_CATEGORY("restoreContainers", "restore");
+	int DockContainerCount = 0;
+	for (const auto& Container : State.Containers)
+	{
+		restoreContainer(DockContainerCount, Container);
+		DockContainerCount++;
+	}
+
+	// Delete remaining empty floating widgets
+	int FloatingWidgetIndex = DockContainerCount - 1;
+	for (int i = FloatingWidgetIndex; i < FloatingWidgets.count(); ++i)
+	{
+		CFloatingDockContainer* floatingWidget = FloatingWidgets[i];
+		if (!floatingWidget) continue;
+		floatingWidget->hide();
+		_this->removeDockContainer(floatingWidget->dockContainer());
+		floatingWidget->deleteLater();
+	}
 }
 
 
 //============================================================================
 void DockManagerPrivate::restoreDockWidgetsOpenState()
 {
+	ADS_TRACE_SCOPE_CATEGORY("restoreDockWidgetsOpenState", "restore");
     // All dock widgets, that have not been processed in the restore state
     // function are invisible to the user now and have no assigned dock area
     // They do not belong to any dock container, until the user toggles the
     // toggle view action the next time
-    for (auto DockWidget : DockWidgetsMap)
+    for (auto DockWidget : DockWidgets.DockWidgets)
     {
     	if (DockWidget->property(internal::DirtyProperty).toBool())
     	{
@@ -397,6 +842,7 @@ void DockManagerPrivate::restoreDockWidgetsOpenState()
 //============================================================================
 void DockManagerPrivate::restoreDockAreasIndices()
 {
+	ADS_TRACE_SCOPE_CATEGORY("restoreDockAreasIndices", "restore");
     // Now all dock areas are properly restored and we setup the index of
     // The dock areas because the previous toggleView() action has changed
     // the dock area index
@@ -459,34 +905,100 @@ void DockManagerPrivate::emitTopLevelEvents()
 
 
 //============================================================================
-bool DockManagerPrivate::restoreState(const QByteArray& State, int version)
+bool DockManagerPrivate::restoreState(const DockingState& StateTree)
 {
-	QByteArray state = State.startsWith("<?xml") ? State : qUncompress(State);
-    if (!checkFormat(state, version))
+	ADS_TRACE_SCOPE_CATEGORY("restoreState", "restore");
+    // Hide updates of floating widgets from user. In incremental mode the
+    // floating widgets are patched in place and stay visible
+    if (!IncrementalRestoreEnabled)
     {
-        ADS_PRINT("checkFormat: Error checking format!!!!!!!");
-    	return false;
+    	hideFloatingWidgets();
     }
-
-    // Hide updates of floating widgets from use
-    hideFloatingWidgets();
     markDockWidgetsDirty();
-
-    if (!restoreStateFromXml(state, version))
-    {
-        ADS_PRINT("restoreState: Error restoring state!!!!!!!");
-    	return false;
-    }
+    restoreContainers(StateTree);
 
     restoreDockWidgetsOpenState();
     restoreDockAreasIndices();
-    emitTopLevelEvents();
+    {
+    	ADS_TRACE_SCOPE_CATEGORY("emitTopLevelEvents", "restore");
+    	emitTopLevelEvents();
+    }
     _this->dumpLayout();
 
     return true;
 }
 
 
+//============================================================================
+bool DockManagerPrivate::runRestore(const std::function<bool()>& Restore)
+{
+	// Prevent multiple calls as long as state is not restore. This may
+	// happen, if QApplication::processEvents() is called somewhere
+	if (RestoringState)
+	{
+		return false;
+	}
+
+	// We hide the complete dock manager here. Restoring the state means
+	// that DockWidgets are removed from the DockArea internal stack layout
+	// which in turn  means, that each time a widget is removed the stack
+	// will show and raise the next available widget which in turn
+	// triggers show events for the dock widgets. To avoid this we hide the
+	// dock manager. Because there will be no processing of application
+	// events until this function is finished, the user will not see this
+	// hiding
+	// In incremental mode only the nodes that differ are touched, so we
+	// just suspend painting instead of hiding the whole dock manager.
+	bool IsHidden = _this->isHidden();
+	bool Incremental = IncrementalRestoreEnabled;
+	bool UpdatesEnabled = _this->updatesEnabled();
+	if (Incremental)
+	{
+		_this->setUpdatesEnabled(false);
+	}
+	else if (!IsHidden)
+	{
+		_this->hide();
+	}
+	RestoringState = true;
+	Q_EMIT _this->restoringState();
+	bool Result = Restore();
+	RestoringState = false;
+	if (Incremental)
+	{
+		_this->setUpdatesEnabled(UpdatesEnabled);
+	}
+	else if (!IsHidden)
+	{
+		_this->show();
+	}
+	Q_EMIT _this->stateRestored();
+	return Result;
+}
+
+
+//============================================================================
+void DockManagerPrivate::cacheXmlFragments(DockingState& State)
+{
+	ADS_TRACE_SCOPE_CATEGORY("cacheXmlFragments", "state");
+	bool AutoFormatting = CDockManager::testConfigFlag(CDockManager::XmlAutoFormattingEnabled);
+	for (int i = 0; i < State.Containers.count(); ++i)
+	{
+		auto& Container = State.Containers[i];
+		if (!Container.XmlFragment.isEmpty()
+		 && Container.XmlFragmentAutoFormatting == AutoFormatting)
+		{
+			continue;
+		}
+
+		Container.XmlFragment = CDockingStateWriter::writeContainerFragment(
+			Container, AutoFormatting);
+		Container.XmlFragmentAutoFormatting = AutoFormatting;
+		Containers[i]->updateStateCache(Container);
+	}
+}
+
+
 //============================================================================
 void DockManagerPrivate::addActionToMenu(QAction* Action, QMenu* Menu, bool InsertSorted)
 {
@@ -520,6 +1032,10 @@ CDockManager::CDockManager(QWidget *parent) :
 	CDockContainerWidget(this, parent),
 	d(new DockManagerPrivate(this))
 {
+	if (qEnvironmentVariableIsSet("ADS_TRACE_FILE"))
+	{
+		CDockTrace::setEnabled(true);
+	}
 	createRootSplitter();
 	createSideTabBarWidgets();
 	QMainWindow* MainWindow = qobject_cast<QMainWindow*>(parent);
@@ -531,6 +1047,15 @@ CDockManager::CDockManager(QWidget *parent) :
 	d->ViewMenu = new QMenu(tr("Show View"), this);
 	d->DockAreaOverlay = new CDockOverlay(this, CDockOverlay::ModeDockAreaOverlay);
 	d->ContainerOverlay = new CDockOverlay(this, CDockOverlay::ModeContainerOverlay);
+	d->HitTestIndex = new CDockHitTestIndex(this);
+	d->DragPreviewCache = new CDragPreviewCache(this);
+	if (CDockManager::testConfigFlag(CDockManager::DragPreviewShowsContentPixmap))
+	{
+		connect(this, &CDockManager::dockWidgetAdded, d->DragPreviewCache,
+			&CDragPreviewCache::watch);
+		connect(this, &CDockManager::dockWidgetRemoved, d->DragPreviewCache,
+			&CDragPreviewCache::forget);
+	}
 	d->Containers.append(this);
 	d->loadStylesheet();
 
@@ -571,6 +1096,11 @@ CDockManager::CDockManager(QWidget *parent) :
 //============================================================================
 CDockManager::~CDockManager()
 {
+	if (qEnvironmentVariableIsSet("ADS_TRACE_FILE"))
+	{
+		CDockTrace::writeChromeTrace(qEnvironmentVariable("ADS_TRACE_FILE"));
+	}
+
     // fix memory leaks, see https://github.com/githubuser0xFFFF/Qt-Advanced-Docking-System/issues/307
 	std::vector<QPointer<ads::CDockAreaWidget>> areas;
 	for (int i = 0; i != dockAreaCount(); ++i)
@@ -769,128 +1299,208 @@ void CDockManager::removeFloatingWidget(CFloatingDockContainer* FloatingWidget)
 void CDockManager::registerDockContainer(CDockContainerWidget* DockContainer)
 {
 	d->Containers.append(DockContainer);
+	d->HitTestIndex->invalidate();
+}
+
+
+//============================================================================
+void CDockManager::removeDockContainer(CDockContainerWidget* DockContainer)
+{
+	if (this != DockContainer)
+	{
+		d->Containers.removeAll(DockContainer);
+		d->HitTestIndex->invalidate();
+	}
+}
+
+
+//============================================================================
+CDockHitTestIndex* CDockManager::hitTestIndex() const
+{
+	return d->HitTestIndex;
+}
+
+
+//============================================================================
+CDragPreviewCache* CDockManager::dragPreviewCache() const
+{
+	return d->DragPreviewCache;
+}
+
+
+//============================================================================
+CDockOverlay* CDockManager::containerOverlay() const
+{
+	return d->ContainerOverlay;
+}
+
+
+//============================================================================
+CDockOverlay* CDockManager::dockAreaOverlay() const
+{
+	return d->DockAreaOverlay;
+}
+
+
+//============================================================================
+const QList<CDockContainerWidget*> CDockManager::dockContainers() const
+{
+	return d->Containers;
+}
+
+
+//============================================================================
+const QList<CFloatingDockContainer*> CDockManager::floatingWidgets() const
+{
+	QList<CFloatingDockContainer*> res;
+	for (auto &fl : d->FloatingWidgets)
+	{
+		if (fl) res.append(fl);
+	}
+	return res;
+}
+
+
+//============================================================================
+unsigned int CDockManager::zOrderIndex() const
+{
+	return 0;
+}
+
+
+//============================================================================
+QByteArray CDockManager::saveState(int version) const
+{
+	return saveState(version, XmlStateFormat);
+}
+
+
+//============================================================================
+QByteArray CDockManager::saveState(int version, eStateFormat Format) const
+{
+	ADS_TRACE_SCOPE_CATEGORY("saveState", "state");
+	auto State = captureState(version);
+	if (d->IncrementalSaveEnabled && XmlStateFormat == Format)
+	{
+		d->cacheXmlFragments(State);
+	}
+	return encodeState(State, Format);
+}
+
+
+//============================================================================
+bool CDockManager::saveState(QIODevice* Device, int version, eStateFormat Format) const
+{
+	ADS_TRACE_SCOPE_CATEGORY("saveState", "state");
+	if (!Device || !Device->isWritable())
+	{
+		return false;
+	}
+
+	auto State = captureState(version);
+	if (d->IncrementalSaveEnabled && XmlStateFormat == Format)
+	{
+		d->cacheXmlFragments(State);
+	}
+	return writeDockingState(State, Device, Format, configFlags());
 }
 
 
 //============================================================================
-void CDockManager::removeDockContainer(CDockContainerWidget* DockContainer)
+DockingState CDockManager::captureState(int version) const
 {
-	if (this != DockContainer)
+	ADS_TRACE_SCOPE_CATEGORY("captureState", "state");
+	DockingState State;
+	State.FileVersion = CurrentVersion;
+	State.UserVersion = version;
+	if (d->CentralWidget && !testConfigFlag(PerspectivesWithOutCentralWidget))
 	{
-		d->Containers.removeAll(DockContainer);
+		State.CentralWidget = d->CentralWidget->objectName();
+	}
+	State.Containers.resize(d->Containers.count());
+	for (int i = 0; i < d->Containers.count(); ++i)
+	{
+		d->Containers[i]->saveState(State.Containers[i]);
 	}
+
+	return State;
 }
 
 
 //============================================================================
-CDockOverlay* CDockManager::containerOverlay() const
+QByteArray CDockManager::encodeState(const DockingState& State, eStateFormat Format)
 {
-	return d->ContainerOverlay;
+	return encodeDockingState(State, Format, configFlags());
 }
 
 
 //============================================================================
-CDockOverlay* CDockManager::dockAreaOverlay() const
+QFuture<QByteArray> CDockManager::saveStateAsync(int version, eStateFormat Format) const
 {
-	return d->DockAreaOverlay;
+	ADS_TRACE_SCOPE_CATEGORY("saveStateAsync", "state");
+	auto Task = new CStateEncodeTask(captureState(version), Format, configFlags());
+	auto Future = Task->Promise.future();
+	d->StateEncoderPool.start(Task);
+	return Future;
 }
 
 
 //============================================================================
-const QList<CDockContainerWidget*> CDockManager::dockContainers() const
+bool CDockManager::restoreState(const QByteArray &state, int version)
 {
-	return d->Containers;
+	QBuffer Buffer;
+	Buffer.setData(state);
+	Buffer.open(QIODevice::ReadOnly);
+	return restoreState(&Buffer, version);
 }
 
 
 //============================================================================
-const QList<CFloatingDockContainer*> CDockManager::floatingWidgets() const
+bool CDockManager::restoreState(QIODevice* Device, int version)
 {
-	QList<CFloatingDockContainer*> res;
-	for (auto &fl : d->FloatingWidgets)
+	if (!Device || !Device->isReadable())
 	{
-		if (fl) res.append(fl);
+		return false;
 	}
-	return res;
-}
 
-
-//============================================================================
-unsigned int CDockManager::zOrderIndex() const
-{
-	return 0;
+	return d->runRestore([&]()
+	{
+		DockingState StateTree;
+		if (!d->readState(Device, version, StateTree))
+		{
+			ADS_PRINT("readState: Error reading state!!!!!!!");
+			return false;
+		}
+		return d->restoreState(StateTree);
+	});
 }
 
 
 //============================================================================
-QByteArray CDockManager::saveState(int version) const
+bool CDockManager::decodeState(const QByteArray& State, int version,
+	DockingState& StateTree) const
 {
-    QByteArray xmldata;
-    QXmlStreamWriter s(&xmldata);
-    auto ConfigFlags = CDockManager::configFlags();
-	s.setAutoFormatting(ConfigFlags.testFlag(XmlAutoFormattingEnabled));
-    s.writeStartDocument();
-		s.writeStartElement("QtAdvancedDockingSystem");
-		s.writeAttribute("Version", QString::number(CurrentVersion));
-		s.writeAttribute("UserVersion", QString::number(version));
-		s.writeAttribute("Containers", QString::number(d->Containers.count()));
-        if (d->CentralWidget && !ConfigFlags.testFlag(PerspectivesWithOutCentralWidget))
-		{
-			s.writeAttribute("CentralWidget", d->CentralWidget->objectName());
-		}
-		for (auto Container : d->Containers)
-		{
-			Container->saveState(s);
-		}
-
-		s.writeEndElement();
-    s.writeEndDocument();
-
-    return ConfigFlags.testFlag(XmlCompressionEnabled)
-    	? qCompress(xmldata, 9) : xmldata;
+	QBuffer Buffer;
+	Buffer.setData(State);
+	Buffer.open(QIODevice::ReadOnly);
+	return d->readState(&Buffer, version, StateTree);
 }
 
 
 //============================================================================
-bool CDockManager::restoreState(const QByteArray &state, int version)
+bool CDockManager::restoreState(const DockingState& StateTree)
 {
-	// Prevent multiple calls as long as state is not restore. This may
-	// happen, if QApplication::processEvents() is called somewhere
-	if (d->RestoringState)
-	{
-		return false;
-	}
-
-	// We hide the complete dock manager here. Restoring the state means
-	// that DockWidgets are removed from the DockArea internal stack layout
-	// which in turn  means, that each time a widget is removed the stack
-	// will show and raise the next available widget which in turn
-	// triggers show events for the dock widgets. To avoid this we hide the
-	// dock manager. Because there will be no processing of application
-	// events until this function is finished, the user will not see this
-	// hiding
-	bool IsHidden = this->isHidden();
-	if (!IsHidden)
+	return d->runRestore([&]()
 	{
-		hide();
-	}
-	d->RestoringState = true;
-	Q_EMIT restoringState();
-	bool Result = d->restoreState(state, version);
-	d->RestoringState = false;
-	if (!IsHidden)
-	{
-		show();
-	}
-	Q_EMIT stateRestored();
-	return Result;
+		return d->checkState(StateTree) && d->restoreState(StateTree);
+	});
 }
 
 
 //============================================================================
 CFloatingDockContainer* CDockManager::addDockWidgetFloating(CDockWidget* Dockwidget)
 {
-	d->DockWidgetsMap.insert(Dockwidget->objectName(), Dockwidget);
+	d->DockWidgets.insert(Dockwidget);
 	CDockAreaWidget* OldDockArea = Dockwidget->dockAreaWidget();
 	if (OldDockArea)
 	{
@@ -977,7 +1587,7 @@ void CDockManager::restoreHiddenFloatingWidgets()
 CDockAreaWidget* CDockManager::addDockWidget(DockWidgetArea area,
 	CDockWidget* Dockwidget, CDockAreaWidget* DockAreaWidget, int Index)
 {
-	d->DockWidgetsMap.insert(Dockwidget->objectName(), Dockwidget);
+	d->DockWidgets.insert(Dockwidget);
 	auto Container = DockAreaWidget ? DockAreaWidget->dockContainer() : this;
 	auto AreaOfAddedDockWidget = Container->addDockWidget(area, Dockwidget, DockAreaWidget, Index);
 	Q_EMIT dockWidgetAdded(Dockwidget);
@@ -988,7 +1598,7 @@ CDockAreaWidget* CDockManager::addDockWidget(DockWidgetArea area,
 CDockAreaWidget* CDockManager::addDockWidgetToContainer(DockWidgetArea area,
 	CDockWidget* Dockwidget, CDockContainerWidget* DockContainerWidget)
 {
-	d->DockWidgetsMap.insert(Dockwidget->objectName(), Dockwidget);
+	d->DockWidgets.insert(Dockwidget);
 	auto AreaOfAddedDockWidget = DockContainerWidget->addDockWidget(area, Dockwidget);
 	Q_EMIT dockWidgetAdded(Dockwidget);
 	return AreaOfAddedDockWidget;
@@ -1004,7 +1614,7 @@ CAutoHideDockContainer* CDockManager::addAutoHideDockWidget(SideBarLocation area
 CAutoHideDockContainer* CDockManager::addAutoHideDockWidgetToContainer(SideBarLocation area, CDockWidget* Dockwidget,
 	CDockContainerWidget* DockContainerWidget)
 {
-	d->DockWidgetsMap.insert(Dockwidget->objectName(), Dockwidget);
+	d->DockWidgets.insert(Dockwidget);
 	auto container = DockContainerWidget->createAndSetupAutoHideContainer(area, Dockwidget);
 	container->collapseView(true);
 
@@ -1040,14 +1650,33 @@ CDockAreaWidget* CDockManager::addDockWidgetTabToArea(CDockWidget* Dockwidget,
 //============================================================================
 CDockWidget* CDockManager::findDockWidget(const QString& ObjectName) const
 {
-	return d->DockWidgetsMap.value(ObjectName, nullptr);
+	return d->DockWidgets.ByName.value(ObjectName, nullptr);
+}
+
+
+//============================================================================
+CDockWidget* CDockManager::findDockWidget(int Handle) const
+{
+	return d->DockWidgets.ByHandle.value(Handle, nullptr);
+}
+
+
+//============================================================================
+CDockWidget* CDockManager::findDockWidget(int Handle, const QString& ObjectName) const
+{
+	auto DockWidget = d->DockWidgets.ByHandle.value(Handle, nullptr);
+	if (DockWidget && DockWidget->objectName() == ObjectName)
+	{
+		return DockWidget;
+	}
+	return findDockWidget(ObjectName);
 }
 
 //============================================================================
 void CDockManager::removeDockWidget(CDockWidget* Dockwidget)
 {
 	Q_EMIT dockWidgetAboutToBeRemoved(Dockwidget);
-	d->DockWidgetsMap.remove(Dockwidget->objectName());
+	d->DockWidgets.remove(Dockwidget);
 	CDockContainerWidget::removeDockWidget(Dockwidget);
 	Dockwidget->setDockManager(nullptr);
 	Q_EMIT dockWidgetRemoved(Dockwidget);
@@ -1056,14 +1685,171 @@ void CDockManager::removeDockWidget(CDockWidget* Dockwidget)
 //============================================================================
 QMap<QString, CDockWidget*> CDockManager::dockWidgetsMap() const
 {
-	return d->DockWidgetsMap;
+	QMap<QString, CDockWidget*> Map;
+	for (auto it = d->DockWidgets.ByName.constBegin(); it != d->DockWidgets.ByName.constEnd(); ++it)
+	{
+		Map.insert(it.key(), it.value());
+	}
+	return Map;
+}
+
+
+//============================================================================
+const QVector<CDockWidget*>& CDockManager::registeredDockWidgets() const
+{
+	return d->DockWidgets.DockWidgets;
+}
+
+
+//============================================================================
+int CDockManager::deferredContentCount() const
+{
+	int Count = 0;
+	for (auto DockWidget : d->DockWidgets.DockWidgets)
+	{
+		Count += DockWidget->hasDeferredContent() ? 1 : 0;
+	}
+	return Count;
+}
+
+
+//============================================================================
+void CDockManager::setContentIdleTimeout(int Milliseconds)
+{
+	d->ContentIdleTimeout = qMax(0, Milliseconds);
+	if (!d->ContentIdleTimeout)
+	{
+		delete d->ContentIdleTimer;
+		d->ContentIdleTimer = nullptr;
+		return;
+	}
+
+	if (!d->ContentIdleTimer)
+	{
+		d->ContentIdleTimer = new QTimer(this);
+		connect(d->ContentIdleTimer, &QTimer::timeout, this,
+			&CDockManager::releaseInactiveContents);
+	}
+	// Checking with a fraction of the timeout keeps the release delay close
+	// to the configured timeout without polling too often
+	d->ContentIdleTimer->start(qBound(1000, d->ContentIdleTimeout / 4, 60000));
+}
+
+
+//============================================================================
+int CDockManager::contentIdleTimeout() const
+{
+	return d->ContentIdleTimeout;
+}
+
+
+//============================================================================
+void CDockManager::setContentBudget(int Budget)
+{
+	d->ContentBudget = qMax(0, Budget);
+	if (d->ContentBudget)
+	{
+		releaseInactiveContents();
+	}
+}
+
+
+//============================================================================
+int CDockManager::contentBudget() const
+{
+	return d->ContentBudget;
+}
+
+
+//============================================================================
+void CDockManager::setTabBarVirtualizationThreshold(int Count)
+{
+	d->TabBarVirtualizationThreshold = qMax(0, Count);
+	for (auto Container : d->Containers)
+	{
+		for (int i = 0; i < Container->dockAreaCount(); ++i)
+		{
+			auto TabBar = Container->dockArea(i)->titleBar()->tabBar();
+			TabBar->setVirtualized(d->TabBarVirtualizationThreshold
+				&& TabBar->count() >= d->TabBarVirtualizationThreshold);
+		}
+	}
+}
+
+
+//============================================================================
+int CDockManager::tabBarVirtualizationThreshold() const
+{
+	return d->TabBarVirtualizationThreshold;
+}
+
+
+//============================================================================
+int CDockManager::releaseInactiveContents()
+{
+	if (!d->ContentIdleTimeout && !d->ContentBudget)
+	{
+		return 0;
+	}
+
+	int LoadedCost = 0;
+	QVector<CDockWidget*> Candidates;
+	for (auto DockWidget : d->DockWidgets.DockWidgets)
+	{
+		if (!DockWidget->isContentReleasable())
+		{
+			continue;
+		}
+
+		LoadedCost += DockWidget->contentCost();
+		if (!DockWidget->isVisible())
+		{
+			Candidates.append(DockWidget);
+		}
+	}
+
+	// Release the contents that are hidden for the longest time first
+	std::sort(Candidates.begin(), Candidates.end(),
+		[](const CDockWidget* a, const CDockWidget* b)
+		{
+			return a->inactiveTime() > b->inactiveTime();
+		});
+
+	int Released = 0;
+	for (auto DockWidget : Candidates)
+	{
+		bool IdleTimedOut = d->ContentIdleTimeout
+			&& DockWidget->inactiveTime() >= d->ContentIdleTimeout;
+		bool OverBudget = d->ContentBudget && LoadedCost > d->ContentBudget;
+		if (!IdleTimedOut && !OverBudget)
+		{
+			// Candidates are sorted, so all remaining contents are newer
+			break;
+		}
+
+		int Cost = DockWidget->contentCost();
+		if (DockWidget->releaseContent())
+		{
+			LoadedCost -= Cost;
+			Released++;
+		}
+	}
+
+	return Released;
 }
 
 
 //============================================================================
 void CDockManager::addPerspective(const QString& UniquePrespectiveName)
 {
-	d->Perspectives.insert(UniquePrespectiveName, saveState());
+	if (d->PerspectiveDeltaEncoding)
+	{
+		d->storePerspective(UniquePrespectiveName, saveState(0, BinaryStateFormat));
+	}
+	else
+	{
+		d->storePerspective(UniquePrespectiveName, saveState());
+	}
 	Q_EMIT perspectiveListChanged();
 }
 
@@ -1081,7 +1867,7 @@ void CDockManager::removePerspectives(const QStringList& Names)
 	int Count = 0;
 	for (const auto& Name : Names)
 	{
-		Count += d->Perspectives.remove(Name);
+		Count += d->removePerspective(Name) ? 1 : 0;
 	}
 
 	if (Count)
@@ -1095,21 +1881,27 @@ void CDockManager::removePerspectives(const QStringList& Names)
 //============================================================================
 QStringList CDockManager::perspectiveNames() const
 {
-	return d->Perspectives.keys();
+	return d->PerspectiveStore->perspectiveNames();
 }
 
 
 //============================================================================
 void CDockManager::openPerspective(const QString& PerspectiveName)
 {
-	const auto Iterator = d->Perspectives.find(PerspectiveName);
-	if (d->Perspectives.end() == Iterator)
+	if (!d->PerspectiveStore->contains(PerspectiveName))
+	{
+		return;
+	}
+
+	ADS_TRACE_SCOPE_CATEGORY("openPerspective", "perspective");
+	const auto State = d->perspectiveState(PerspectiveName);
+	if (State.isEmpty())
 	{
 		return;
 	}
 
 	Q_EMIT openingPerspective(PerspectiveName);
-	restoreState(Iterator.value());
+	restoreState(State);
 	Q_EMIT perspectiveOpened(PerspectiveName);
 }
 
@@ -1117,23 +1909,33 @@ void CDockManager::openPerspective(const QString& PerspectiveName)
 //============================================================================
 void CDockManager::savePerspectives(QSettings& Settings) const
 {
-	Settings.beginWriteArray("Perspectives", d->Perspectives.size());
+	const auto Names = d->PerspectiveStore->perspectiveNames();
+	Settings.beginWriteArray("Perspectives", Names.size());
 	int i = 0;
-	for (auto it = d->Perspectives.constBegin(); it != d->Perspectives.constEnd(); ++it)
+	for (const auto& Name : Names)
 	{
 		Settings.setArrayIndex(i);
-		Settings.setValue("Name", it.key());
-		Settings.setValue("State", it.value());
+		Settings.setValue("Name", Name);
+		Settings.setValue("State", d->PerspectiveStore->perspective(Name));
 		++i;
 	}
 	Settings.endArray();
 }
 
 
+//============================================================================
+bool CDockManager::savePerspectives() const
+{
+	ADS_TRACE_SCOPE_CATEGORY("savePerspectives", "perspective");
+	return d->PerspectiveStore->save();
+}
+
+
 //============================================================================
 void CDockManager::loadPerspectives(QSettings& Settings)
 {
-	d->Perspectives.clear();
+	d->PerspectiveStore->clear();
+	d->BasePerspectiveValid = false;
 	int Size = Settings.beginReadArray("Perspectives");
 	if (!Size)
 	{
@@ -1151,7 +1953,7 @@ void CDockManager::loadPerspectives(QSettings& Settings)
 			continue;
 		}
 
-		d->Perspectives.insert(Name, Data);
+		d->PerspectiveStore->setPerspective(Name, Data);
 	}
 
 	Settings.endArray();
@@ -1160,6 +1962,45 @@ void CDockManager::loadPerspectives(QSettings& Settings)
 }
 
 
+//============================================================================
+bool CDockManager::loadPerspectives()
+{
+	ADS_TRACE_SCOPE_CATEGORY("loadPerspectives", "perspective");
+	bool Result = d->PerspectiveStore->load();
+	d->BasePerspectiveValid = false;
+	Q_EMIT perspectiveListChanged();
+	Q_EMIT perspectiveListLoaded();
+	return Result;
+}
+
+
+//============================================================================
+void CDockManager::setPerspectiveStore(IPerspectiveStore* Store)
+{
+	setPerspectiveStore(QSharedPointer<IPerspectiveStore>(Store));
+}
+
+
+//============================================================================
+void CDockManager::setPerspectiveStore(QSharedPointer<IPerspectiveStore> Store)
+{
+	if (!Store)
+	{
+		Store.reset(new CMemoryPerspectiveStore());
+	}
+	d->PerspectiveStore = Store;
+	d->BasePerspectiveValid = false;
+	Q_EMIT perspectiveListChanged();
+}
+
+
+//============================================================================
+QSharedPointer<IPerspectiveStore> CDockManager::perspectiveStore() const
+{
+	return d->PerspectiveStore;
+}
+
+
 //============================================================================
 CDockWidget* CDockManager::centralWidget() const
 {
@@ -1186,7 +2027,7 @@ CDockAreaWidget* CDockManager::setCentralWidget(CDockWidget* widget)
 
 	// Setting a central widget is now allowed if there are already other
 	// dock widgets.
-	if (!d->DockWidgetsMap.isEmpty())
+	if (!d->DockWidgets.DockWidgets.isEmpty())
 	{
 		qWarning("Setting a central widget not possible - the central widget need to be the first "
 			"dock widget that is added to the dock manager.");
@@ -1425,6 +2266,11 @@ void CDockManager::setSplitterSizes(CDockAreaWidget *ContainedArea, const QList<
     if (Splitter && Splitter->count() == sizes.count())
     {
         Splitter->setSizes(sizes);
+        auto DockContainer = ContainedArea->dockContainer();
+        if (DockContainer)
+        {
+        	DockContainer->markStateDirty();
+        }
     }
 }
 
@@ -1521,7 +2367,7 @@ void CDockManager::lockDockWidgetFeaturesGlobally(CDockWidget::DockWidgetFeature
 	d->LockedDockWidgetFeatures = Value;
 	// Call the notifyFeaturesChanged() function for all dock widgets to update
 	// the state of the close and detach buttons
-    for (auto DockWidget : d->DockWidgetsMap)
+    for (auto DockWidget : d->DockWidgets.DockWidgets)
     {
     	DockWidget->notifyFeaturesChanged();
     }
@@ -1563,6 +2409,94 @@ bool CDockManager::isDockingOnDragEnabled() const
 }
 
 
+//===========================================================================
+void CDockManager::setIncrementalRestoreEnabled(bool Enabled)
+{
+	d->IncrementalRestoreEnabled = Enabled;
+}
+
+
+//===========================================================================
+bool CDockManager::isIncrementalRestoreEnabled() const
+{
+	return d->IncrementalRestoreEnabled;
+}
+
+
+//===========================================================================
+void CDockManager::setIncrementalSaveEnabled(bool Enabled)
+{
+	d->IncrementalSaveEnabled = Enabled;
+	if (!Enabled)
+	{
+		for (auto Container : d->Containers)
+		{
+			Container->clearStateCache();
+		}
+	}
+}
+
+
+//===========================================================================
+bool CDockManager::isIncrementalSaveEnabled() const
+{
+	return d->IncrementalSaveEnabled;
+}
+
+
+//===========================================================================
+void CDockManager::setPerspectiveDeltaEncodingEnabled(bool Enabled)
+{
+	d->PerspectiveDeltaEncoding = Enabled;
+}
+
+
+//===========================================================================
+bool CDockManager::isPerspectiveDeltaEncodingEnabled() const
+{
+	return d->PerspectiveDeltaEncoding;
+}
+
+
+//============================================================================
+void CDockManager::beginLayoutUpdate()
+{
+	d->LayoutUpdateDepth++;
+}
+
+
+//============================================================================
+void CDockManager::endLayoutUpdate()
+{
+	if (d->LayoutUpdateDepth <= 0 || --d->LayoutUpdateDepth > 0)
+	{
+		return;
+	}
+
+	// The deferred signals may close or delete floating containers
+	QList<QPointer<CDockContainerWidget>> Containers;
+	for (auto DockContainer : d->Containers)
+	{
+		Containers.append(DockContainer);
+	}
+
+	for (auto DockContainer : Containers)
+	{
+		if (DockContainer)
+		{
+			DockContainer->applyDeferredLayoutUpdate();
+		}
+	}
+}
+
+
+//============================================================================
+bool CDockManager::isLayoutUpdateActive() const
+{
+	return d->LayoutUpdateDepth > 0;
+}
+
+
 //===========================================================================
 void CDockManager::setConfigParam(CDockManager::eConfigParam Param, QVariant Value)
 {
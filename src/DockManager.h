@@ -30,6 +30,8 @@
 //============================================================================
 //                                   INCLUDES
 //============================================================================
+#include <QFuture>
+
 #include "ads_globals.h"
 #include "DockContainerWidget.h"
 #include "DockWidget.h"
@@ -53,7 +55,11 @@ struct DockWidgetTabPrivate;
 struct DockAreaWidgetPrivate;
 class CIconProvider;
 class CDockComponentsFactory;
+class IPerspectiveStore;
+struct DockingState;
 class CDockFocusController;
+class CDockHitTestIndex;
+class CDragPreviewCache;
 class CAutoHideSideBar;
 class CAutoHideTab;
 struct AutoHideTabPrivate;
@@ -279,6 +285,15 @@ public:
     	ConfigParamCount // just a delimiter to count number of config params
 	};
 
+	/**
+	 * Data formats supported by saveState() and restoreState()
+	 */
+	enum eStateFormat
+	{
+		XmlStateFormat, ///< XML data, optionally compressed if XmlCompressionEnabled is set
+		BinaryStateFormat ///< compact binary data with interned dock widget names
+	};
+
 
 	/**
 	 * Default Constructor.
@@ -462,17 +477,90 @@ public:
 	 */
 	CDockWidget* findDockWidget(const QString& ObjectName) const;
 
+	/**
+	 * Searches for a registered dock widget with the given handle.
+	 * Looking up a dock widget by its handle does not require any string
+	 * hashing or comparison.
+	 * \see CDockWidget::handle()
+	 */
+	CDockWidget* findDockWidget(int Handle) const;
+
+	/**
+	 * Searches for a registered dock widget with the given handle and
+	 * ObjectName. If the dock widget with the given handle still has the
+	 * given object name, it is returned. Otherwise the dock widget is looked
+	 * up by its object name. This is used when restoring a state that may
+	 * have been captured in this session.
+	 */
+	CDockWidget* findDockWidget(int Handle, const QString& ObjectName) const;
+
 	/**
 	 * Remove the given Dock from the dock manager
 	 */
 	void removeDockWidget(CDockWidget* Dockwidget);
 
 	/**
-	 * This function returns a readable reference to the internal dock
-	 * widgets map so that it is possible to iterate over all dock widgets
+	 * This function returns a map of all registered dock widgets sorted by
+	 * their object names. The map is created on each call, so prefer
+	 * registeredDockWidgets() for iteration and findDockWidget() for lookup.
 	 */
 	QMap<QString, CDockWidget*> dockWidgetsMap() const;
 
+	/**
+	 * Returns a reference to the list of all registered dock widgets in the
+	 * order of their registration. Iterating this list does not copy any
+	 * container. The list must not be used after dock widgets have been
+	 * added to or removed from the dock manager.
+	 */
+	const QVector<CDockWidget*>& registeredDockWidgets() const;
+
+	/**
+	 * Returns the number of registered dock widgets with the DeferredContent
+	 * feature whose content widget has not been created yet
+	 */
+	int deferredContentCount() const;
+
+	/**
+	 * Sets the time in milliseconds after which the content of a hidden dock
+	 * widget is released by releaseInactiveContents(). Only dock widgets
+	 * with the DeferredContent feature and a widget factory release their
+	 * content. A value of 0 disables the idle timeout (default).
+	 * If a timeout is set, releaseInactiveContents() is called periodically.
+	 */
+	void setContentIdleTimeout(int Milliseconds);
+
+	/**
+	 * Returns the content idle timeout in milliseconds
+	 */
+	int contentIdleTimeout() const;
+
+	/**
+	 * Sets the budget for the summed CDockWidget::contentCost() of all loaded
+	 * releasable contents. If the budget is exceeded, the contents of the
+	 * longest hidden dock widgets are released until the budget is met
+	 * again. A value of 0 means no budget (default).
+	 */
+	void setContentBudget(int Budget);
+
+	/**
+	 * Returns the content budget
+	 */
+	int contentBudget() const;
+
+	/**
+	 * Sets the number of tabs from which on the tab bar of a dock area
+	 * switches to the virtualized mode. In virtualized mode only the tabs
+	 * in or near the visible part of the tab bar are laid out.
+	 * A value of 0 disables the automatic virtualization (default).
+	 * \see CDockAreaTabBar::setVirtualized()
+	 */
+	void setTabBarVirtualizationThreshold(int Count);
+
+	/**
+	 * Returns the tab bar virtualization threshold
+	 */
+	int tabBarVirtualizationThreshold() const;
+
 	/**
 	 * Returns the list of all active and visible dock containers
 	 * Dock containers are the main dock manager and all floating widgets
@@ -504,16 +592,100 @@ public:
 	 */
 	QByteArray saveState(int version = 0) const;
 
+	/**
+	 * Saves the current state in the given format.
+	 * The BinaryStateFormat is faster to encode and to decode than the XML
+	 * format and is never compressed. It is intended for frequent snapshots
+	 * like crash recovery data. restoreState() detects the format
+	 * automatically.
+	 * \see restoreState()
+	 */
+	QByteArray saveState(int version, eStateFormat Format) const;
+
+	/**
+	 * Captures the current layout into a state tree that contains only the
+	 * names, flags, sizes and geometries of the layout.
+	 * This is the only part of saving a state that needs to run in the GUI
+	 * thread. The returned tree does not reference any widget and can be
+	 * passed to encodeState() in any thread.
+	 * \see saveStateAsync()
+	 */
+	DockingState captureState(int version = 0) const;
+
+	/**
+	 * Encodes a captured state tree in the given format.
+	 * The XML format is auto formatted and compressed according to the
+	 * current XmlAutoFormattingEnabled and XmlCompressionEnabled flags.
+	 * This function is thread safe.
+	 */
+	static QByteArray encodeState(const DockingState& State,
+		eStateFormat Format = XmlStateFormat);
+
+	/**
+	 * Captures the current layout in the GUI thread and encodes and
+	 * compresses it in a worker thread. The returned future delivers the
+	 * same data as saveState(). Use a QFutureWatcher to get notified when
+	 * the data is ready.
+	 * The states of multiple calls are encoded in the order of the calls.
+	 * \code
+	 * auto Watcher = new QFutureWatcher<QByteArray>(this);
+	 * connect(Watcher, &QFutureWatcher<QByteArray>::finished, [Watcher]()
+	 * {
+	 *     writeAutoSaveFile(Watcher->result());
+	 *     Watcher->deleteLater();
+	 * });
+	 * Watcher->setFuture(DockManager->saveStateAsync());
+	 * \endcode
+	 */
+	QFuture<QByteArray> saveStateAsync(int version = 0,
+		eStateFormat Format = XmlStateFormat) const;
+
+	/**
+	 * Streams the current state into the given device, that needs to be
+	 * open for writing. The XML format is written element by element
+	 * without building the complete document in memory. If the
+	 * XmlCompressionEnabled config flag is set, the XML is deflated while it
+	 * is written. Returns false, if writing to the device failed.
+	 * \see restoreState(QIODevice*, int)
+	 */
+	bool saveState(QIODevice* Device, int version = 0,
+		eStateFormat Format = XmlStateFormat) const;
+
 	/**
 	 * Restores the state of this dockmanagers dockwidgets.
 	 * The version number is compared with that stored in state. If they do
 	 * not match, the dockmanager's state is left unchanged, and this function
 	 * returns false; otherwise, the state is restored, and this function
 	 * returns true.
+	 * The state may be in any of the formats supported by saveState().
 	 * \see saveState()
 	 */
 	bool restoreState(const QByteArray &state, int version = 0);
 
+	/**
+	 * Restores the state from the given device, that needs to be open for
+	 * reading. XML and compressed XML states are parsed while they are
+	 * read from the device, so large states do not need to be loaded into
+	 * memory completely.
+	 * \see saveState(QIODevice*, int, eStateFormat)
+	 */
+	bool restoreState(QIODevice* Device, int version = 0);
+
+	/**
+	 * Parses and validates the given state in any of the formats supported
+	 * by saveState() into a state tree without touching any widget.
+	 * Returns false, if the state is not valid for this dock manager and
+	 * the given version.
+	 * \see restoreState(const DockingState&)
+	 */
+	bool decodeState(const QByteArray& State, int version, DockingState& StateTree) const;
+
+	/**
+	 * Creates the layout from a state tree that has been returned by
+	 * decodeState() or captureState().
+	 */
+	bool restoreState(const DockingState& StateTree);
+
 	/**
 	 * Saves the current perspective to the internal list of perspectives.
 	 * A perspective is the current state of the dock manager assigned
@@ -541,14 +713,53 @@ public:
 
 	/**
 	 * Saves the perspectives to the given settings file.
+	 * This reads the state of all perspectives from the perspective store.
 	 */
 	void savePerspectives(QSettings& Settings) const;
 
 	/**
-	 * Loads the perspectives from the given settings file
+	 * Loads the perspectives from the given settings file into the
+	 * perspective store. All perspectives in the store are replaced.
 	 */
 	void loadPerspectives(QSettings& Settings);
 
+	/**
+	 * Writes the changed perspectives back into the backing storage of the
+	 * perspective store.
+	 * Returns false, if not all changes could be written.
+	 * \see IPerspectiveStore::save()
+	 */
+	bool savePerspectives() const;
+
+	/**
+	 * Loads the list of perspectives from the backing storage of the
+	 * perspective store. Depending on the store, the states of the
+	 * perspectives are not read until a perspective is opened.
+	 * \see IPerspectiveStore::load()
+	 */
+	bool loadPerspectives();
+
+	/**
+	 * Sets the store for the perspectives. The dock manager takes the
+	 * ownership of the given store. If Store is a nullptr, the default
+	 * in-memory store is used.
+	 * The perspectives in the previous store are not copied into the new
+	 * store. Call loadPerspectives() to load the list of perspectives of
+	 * the new store.
+	 */
+	void setPerspectiveStore(IPerspectiveStore* Store);
+
+	/**
+	 * Sets the store for the perspectives and shares its ownership.
+	 */
+	void setPerspectiveStore(QSharedPointer<IPerspectiveStore> Store);
+
+	/**
+	 * Returns the store of the perspectives.
+	 * \see setPerspectiveStore()
+	 */
+	QSharedPointer<IPerspectiveStore> perspectiveStore() const;
+
     /**
      * This function returns managers central widget or nullptr if no central widget is set.
      */
@@ -766,6 +977,124 @@ public:
 	 */
 	bool isDockingOnDragEnabled() const;
 
+	/**
+	 * Enables incremental state restoring.
+	 * If enabled, restoreState() and openPerspective() compare the live
+	 * layout with the target state and reuse existing dock areas and splitters
+	 * where the structure matches. Only the nodes that differ are created,
+	 * moved or destroyed and the dock manager is not hidden during restoring.
+	 * Default is disabled.
+	 */
+	void setIncrementalRestoreEnabled(bool Enabled);
+
+	/**
+	 * Returns true if incremental state restoring is enabled
+	 */
+	bool isIncrementalRestoreEnabled() const;
+
+	/**
+	 * Enables incremental state saving.
+	 * If enabled, each dock container caches its captured state and its
+	 * encoded XML fragment. saveState() only captures and encodes the
+	 * containers that changed since the last call and splices the cached
+	 * fragments of all other containers into the result, so frequent
+	 * autosaving costs time proportional to the changes. saveStateAsync()
+	 * uses the cached fragments but does not update them.
+	 * Default is disabled.
+	 * \see CDockContainerWidget::markStateDirty()
+	 */
+	void setIncrementalSaveEnabled(bool Enabled);
+
+	/**
+	 * Returns true if incremental state saving is enabled
+	 */
+	bool isIncrementalSaveEnabled() const;
+
+	/**
+	 * Enables delta encoding of perspectives.
+	 * If enabled, addPerspective() saves the state in the BinaryStateFormat
+	 * and stores it as delta against a base perspective. The first
+	 * perspective that is added becomes the base. Because perspectives
+	 * usually differ only in a few dock widgets or splitter sizes, the
+	 * stored data is a small fraction of the full state. Delta encoded
+	 * perspectives can always be opened, even if delta encoding is disabled
+	 * later. Default is disabled.
+	 */
+	void setPerspectiveDeltaEncodingEnabled(bool Enabled);
+
+	/**
+	 * Returns true if delta encoding of perspectives is enabled
+	 */
+	bool isPerspectiveDeltaEncodingEnabled() const;
+
+	/**
+	 * Starts a batched layout update.
+	 * While a layout update is active, adding, removing, showing or hiding
+	 * dock widgets does not update splitter handles, title bar visibility
+	 * and tabs menus and does not emit topLevelChanged(), dockAreasAdded()
+	 * and dockAreasRemoved() signals. The deferred work is applied once
+	 * when the last endLayoutUpdate() call ends the update. Calls can be
+	 * nested.
+	 * \code
+	 * DockManager->beginLayoutUpdate();
+	 * for (auto DockWidget : DockWidgets)
+	 * {
+	 *     DockManager->addDockWidgetTab(CenterDockWidgetArea, DockWidget);
+	 * }
+	 * DockManager->endLayoutUpdate();
+	 * \endcode
+	 * \see LayoutUpdateGuard
+	 */
+	void beginLayoutUpdate();
+
+	/**
+	 * Ends a batched layout update started with beginLayoutUpdate()
+	 */
+	void endLayoutUpdate();
+
+	/**
+	 * Returns true, if a batched layout update is active
+	 */
+	bool isLayoutUpdateActive() const;
+
+	/**
+	 * Calls beginLayoutUpdate() on construction and endLayoutUpdate() on
+	 * destruction
+	 */
+	class LayoutUpdateGuard
+	{
+	private:
+		CDockManager* m_DockManager;
+
+	public:
+		LayoutUpdateGuard(CDockManager* DockManager)
+			: m_DockManager(DockManager)
+		{
+			m_DockManager->beginLayoutUpdate();
+		}
+
+		~LayoutUpdateGuard()
+		{
+			m_DockManager->endLayoutUpdate();
+		}
+
+		LayoutUpdateGuard(const LayoutUpdateGuard&) = delete;
+		LayoutUpdateGuard& operator=(const LayoutUpdateGuard&) = delete;
+	};
+
+	/**
+	 * Returns the hit test index that is used for the drop target lookup
+	 * during drag operations. Use CDockHitTestIndex::statistics() to query
+	 * the drag frame latency of the current or last drag operation.
+	 */
+	CDockHitTestIndex* hitTestIndex() const;
+
+	/**
+	 * Returns the cache for the content snapshots that are shown by the
+	 * drag preview if the DragPreviewShowsContentPixmap flag is set
+	 */
+	CDragPreviewCache* dragPreviewCache() const;
+
 	/**
 	 * Update the stylesheet settings through this interface
 	 * 
@@ -782,6 +1111,13 @@ public Q_SLOTS:
 	 */
 	void openPerspective(const QString& PerspectiveName);
 
+	/**
+	 * Releases the contents of hidden dock widgets that are inactive longer
+	 * than the content idle timeout or that exceed the content budget.
+	 * Returns the number of released contents.
+	 */
+	int releaseInactiveContents();
+
 	/**
 	 * Request a focus change to the given dock widget.
 	 * This function only has an effect, if the flag CDockManager::FocusStyling
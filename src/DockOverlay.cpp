@@ -35,6 +35,9 @@
 #include <QDebug>
 #include <QMap>
 #include <QWindow>
+#include <QScreen>
+#include <QTimer>
+#include <QGuiApplication>
 
 #include "DockAreaWidget.h"
 #include "DockAreaTitleBar.h"
@@ -42,6 +45,7 @@
 #include "AutoHideSideBar.h"
 #include "DockManager.h"
 #include "DockAreaTabBar.h"
+#include "DockHitTestIndex.h"
 
 #include <iostream>
 
@@ -63,14 +67,47 @@ struct DockOverlayPrivate
 	DockWidgetArea LastLocation = InvalidDockWidgetArea;
 	bool DropPreviewEnabled = true;
 	CDockOverlay::eMode Mode = CDockOverlay::ModeDockAreaOverlay;
-	QRect DropAreaRect;
 	int TabIndex = InvalidTabIndex;
+	QTimer* UpdateTimer = nullptr;
+	bool UpdatePending = false;
+	int FrameInterval = 16;
+	bool DropAreaValid = false;
+	QPoint DropAreaCursorPos;
+	QRect DropAreaGeometry;
+	DockWidgetArea DropArea = InvalidDockWidgetArea;
 
 	/**
 	 * Private data constructor
 	 */
 	DockOverlayPrivate(CDockOverlay* _public) : _this(_public) {}
 
+	/**
+	 * Discards the cached drop area
+	 */
+	void invalidateDropArea() {DropAreaValid = false;}
+
+	/**
+	 * Updates the frame interval from the refresh rate of the screen
+	 * the overlay is shown on
+	 */
+	void updateFrameInterval();
+
+	/**
+	 * Repaints the overlay at most once per display frame. A repaint that
+	 * is requested during a frame is deferred to the end of the frame.
+	 */
+	void scheduleUpdate();
+
+	/**
+	 * Computes the drop area for the given global cursor position
+	 */
+	DockWidgetArea computeDropArea(const QPoint& CursorPos);
+
+	/**
+	 * Returns the drop preview rectangle for the given drop area
+	 */
+	QRect dropAreaRect(DockWidgetArea Area);
+
 	/**
 	 * Returns the overlay width / height depending on the visibility
 	 * of the sidebar
@@ -396,6 +433,126 @@ int DockOverlayPrivate::sideBarMouseZone(SideBarLocation sideBarLocation)
 }
 
 
+//============================================================================
+void DockOverlayPrivate::updateFrameInterval()
+{
+	auto Window = _this->windowHandle();
+	auto Screen = Window ? Window->screen() : QGuiApplication::primaryScreen();
+	qreal RefreshRate = Screen ? Screen->refreshRate() : 0;
+	FrameInterval = (RefreshRate >= 1) ? qMax(1, qRound(1000 / RefreshRate)) : 16;
+}
+
+
+//============================================================================
+void DockOverlayPrivate::scheduleUpdate()
+{
+	if (UpdateTimer->isActive())
+	{
+		UpdatePending = true;
+		return;
+	}
+
+	_this->repaint();
+	UpdateTimer->start(FrameInterval);
+}
+
+
+//============================================================================
+DockWidgetArea DockOverlayPrivate::computeDropArea(const QPoint& CursorPos)
+{
+	TabIndex = InvalidTabIndex;
+	if (!TargetWidget)
+	{
+		return InvalidDockWidgetArea;
+	}
+
+	DockWidgetArea Result = Cross->cursorLocation();
+	if (Result != InvalidDockWidgetArea)
+	{
+		return Result;
+	}
+
+	auto DockArea = qobject_cast<CDockAreaWidget*>(TargetWidget.data());
+	if (!DockArea && CDockManager::autoHideConfigFlags().testFlag(CDockManager::AutoHideFeatureEnabled))
+	{
+		auto Rect = _this->rect();
+		const QPoint pos = _this->mapFromGlobal(CursorPos);
+		if ((pos.x() < sideBarMouseZone(SideBarLeft))
+		  && AllowedAreas.testFlag(LeftAutoHideArea))
+		{
+			Result = LeftAutoHideArea;
+		}
+		else if (pos.x() > (Rect.width() - sideBarMouseZone(SideBarRight))
+			  && AllowedAreas.testFlag(RightAutoHideArea))
+		{
+			Result = RightAutoHideArea;
+		}
+		else if (pos.y() < sideBarMouseZone(SideBarTop)
+			&& AllowedAreas.testFlag(TopAutoHideArea))
+		{
+			Result = TopAutoHideArea;
+		}
+		else if (pos.y() > (Rect.height() - sideBarMouseZone(SideBarBottom))
+			&& AllowedAreas.testFlag(BottomAutoHideArea))
+		{
+			Result = BottomAutoHideArea;
+		}
+
+		auto SideBarLocation = ads::internal::toSideBarLocation(Result);
+		if (SideBarLocation != SideBarNone)
+		{
+			auto Container = qobject_cast<CDockContainerWidget*>(TargetWidget.data());
+			auto SideBar = Container->autoHideSideBar(SideBarLocation);
+			if (SideBar->isVisible())
+			{
+				TabIndex = SideBar->tabInsertIndexAt(SideBar->mapFromGlobal(CursorPos));
+			}
+		}
+		return Result;
+	}
+	else if (!DockArea)
+	{
+		return Result;
+	}
+
+	if (DockArea->allowedAreas().testFlag(CenterDockWidgetArea)
+	 && !DockArea->titleBar()->isHidden()
+	 && DockArea->titleBarGeometry().contains(DockArea->mapFromGlobal(CursorPos)))
+	{
+		auto TabBar = DockArea->titleBar()->tabBar();
+		TabIndex = TabBar->tabInsertIndexAt(TabBar->mapFromGlobal(CursorPos));
+		return CenterDockWidgetArea;
+	}
+
+	return Result;
+}
+
+
+//============================================================================
+QRect DockOverlayPrivate::dropAreaRect(DockWidgetArea Area)
+{
+	QRect r = _this->rect();
+	double Factor = (CDockOverlay::ModeContainerOverlay == Mode) ?
+		3 : 2;
+
+	switch (Area)
+	{
+    case TopDockWidgetArea: r.setHeight(r.height() / Factor); break;
+	case RightDockWidgetArea: r.setX(r.width() * (1 - 1 / Factor)); break;
+	case BottomDockWidgetArea: r.setY(r.height() * (1 - 1 / Factor)); break;
+	case LeftDockWidgetArea: r.setWidth(r.width() / Factor); break;
+	case CenterDockWidgetArea: r = _this->rect();break;
+	case LeftAutoHideArea: r.setWidth(sideBarOverlaySize(SideBarLeft)); break;
+	case RightAutoHideArea: r.setX(r.width() - sideBarOverlaySize(SideBarRight)); break;
+	case TopAutoHideArea: r.setHeight(sideBarOverlaySize(SideBarTop)); break;
+	case BottomAutoHideArea: r.setY(r.height() - sideBarOverlaySize(SideBarBottom)); break;
+	default: return QRect();
+	}
+
+	return r;
+}
+
+
 //============================================================================
 CDockOverlay::CDockOverlay(QWidget* parent, eMode Mode) :
 	QFrame(parent),
@@ -403,6 +560,17 @@ CDockOverlay::CDockOverlay(QWidget* parent, eMode Mode) :
 {
 	d->Mode = Mode;
 	d->Cross = new CDockOverlayCross(this);
+	d->UpdateTimer = new QTimer(this);
+	d->UpdateTimer->setSingleShot(true);
+	connect(d->UpdateTimer, &QTimer::timeout, [this]()
+	{
+		if (d->UpdatePending)
+		{
+			d->UpdatePending = false;
+			update();
+			d->UpdateTimer->start(d->FrameInterval);
+		}
+	});
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
 	setWindowFlags(Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::X11BypassWindowManagerHint);
 #else
@@ -433,6 +601,7 @@ void CDockOverlay::setAllowedAreas(DockWidgetAreas areas)
 		return;
 	}
 	d->AllowedAreas = areas;
+	d->invalidateDropArea();
 	d->Cross->reset();
 }
 
@@ -444,6 +613,7 @@ void CDockOverlay::setAllowedArea(DockWidgetArea area, bool Enable)
 	d->AllowedAreas.setFlag(area, Enable);
 	if (AreasOld != d->AllowedAreas)
 	{
+		d->invalidateDropArea();
 		d->Cross->reset();
 	}
 }
@@ -459,72 +629,21 @@ DockWidgetAreas CDockOverlay::allowedAreas() const
 //============================================================================
 DockWidgetArea CDockOverlay::dropAreaUnderCursor() const
 {
-	d->TabIndex = InvalidTabIndex;
-	if (!d->TargetWidget)
-	{
-		return InvalidDockWidgetArea;
-	}
-
-	DockWidgetArea Result = d->Cross->cursorLocation();
-	if (Result != InvalidDockWidgetArea)
-	{
-		return Result;
-	}
-
+	// The drop area is computed only once for each cursor position and
+	// overlay geometry and shared between showOverlay(), paintEvent() and
+	// dropOverlayRect()
 	auto CursorPos = QCursor::pos();
-	auto DockArea = qobject_cast<CDockAreaWidget*>(d->TargetWidget.data());
-	if (!DockArea && CDockManager::autoHideConfigFlags().testFlag(CDockManager::AutoHideFeatureEnabled))
+	if (d->DropAreaValid && d->DropAreaCursorPos == CursorPos
+	 && d->DropAreaGeometry == geometry())
 	{
-		auto Rect = rect();
-		const QPoint pos = mapFromGlobal(QCursor::pos());
-		if ((pos.x() < d->sideBarMouseZone(SideBarLeft))
-		  && d->AllowedAreas.testFlag(LeftAutoHideArea))
-		{
-			Result = LeftAutoHideArea;
-		}
-		else if (pos.x() > (Rect.width() - d->sideBarMouseZone(SideBarRight))
-			  && d->AllowedAreas.testFlag(RightAutoHideArea))
-		{
-			Result = RightAutoHideArea;
-		}
-		else if (pos.y() < d->sideBarMouseZone(SideBarTop)
-			&& d->AllowedAreas.testFlag(TopAutoHideArea))
-		{
-			Result = TopAutoHideArea;
-		}
-		else if (pos.y() > (Rect.height() - d->sideBarMouseZone(SideBarBottom))
-			&& d->AllowedAreas.testFlag(BottomAutoHideArea))
-		{
-			Result = BottomAutoHideArea;
-		}
-
-		auto SideBarLocation = ads::internal::toSideBarLocation(Result);
-		if (SideBarLocation != SideBarNone)
-		{
-			auto Container = qobject_cast<CDockContainerWidget*>(d->TargetWidget.data());
-			auto SideBar = Container->autoHideSideBar(SideBarLocation);
-			if (SideBar->isVisible())
-			{
-				d->TabIndex = SideBar->tabInsertIndexAt(SideBar->mapFromGlobal(CursorPos));
-			}
-		}
-		return Result;
-	}
-	else if (!DockArea)
-	{
-		return Result;
-	}
-
-	if (DockArea->allowedAreas().testFlag(CenterDockWidgetArea)
-	 && !DockArea->titleBar()->isHidden()
-	 && DockArea->titleBarGeometry().contains(DockArea->mapFromGlobal(CursorPos)))
-	{
-		auto TabBar = DockArea->titleBar()->tabBar();
-		d->TabIndex = TabBar->tabInsertIndexAt(TabBar->mapFromGlobal(CursorPos));
-		return CenterDockWidgetArea;
+		return d->DropArea;
 	}
 
-	return Result;
+	d->DropArea = d->computeDropArea(CursorPos);
+	d->DropAreaCursorPos = CursorPos;
+	d->DropAreaGeometry = geometry();
+	d->DropAreaValid = true;
+	return d->DropArea;
 }
 
 
@@ -558,7 +677,7 @@ DockWidgetArea CDockOverlay::showOverlay(QWidget* target)
 		DockWidgetArea da = dropAreaUnderCursor();
 		if (da != d->LastLocation)
 		{
-			repaint();
+			d->scheduleUpdate();
 			d->LastLocation = da;
 		}
 		return da;
@@ -566,6 +685,7 @@ DockWidgetArea CDockOverlay::showOverlay(QWidget* target)
 
 	d->TargetWidget = target;
 	d->LastLocation = InvalidDockWidgetArea;
+	d->invalidateDropArea();
 
 	// Move it over the target.
 	hide();
@@ -573,6 +693,7 @@ DockWidgetArea CDockOverlay::showOverlay(QWidget* target)
 	QPoint TopLeft = target->mapToGlobal(target->rect().topLeft());
 	move(TopLeft);
 	show();
+	d->updateFrameInterval();
 	d->Cross->updatePosition();
 	d->Cross->updateOverlayIcons();
 	return dropAreaUnderCursor();
@@ -585,15 +706,24 @@ void CDockOverlay::hideOverlay()
 	hide();
 	d->TargetWidget.clear();
 	d->LastLocation = InvalidDockWidgetArea;
-	d->DropAreaRect = QRect();
+	d->invalidateDropArea();
+	d->UpdateTimer->stop();
+	d->UpdatePending = false;
 }
 
 
 //============================================================================
 void CDockOverlay::enableDropPreview(bool Enable)
 {
+	if (d->DropPreviewEnabled == Enable)
+	{
+		return;
+	}
 	d->DropPreviewEnabled = Enable;
-	update();
+	if (isVisible())
+	{
+		d->scheduleUpdate();
+	}
 }
 
 
@@ -609,30 +739,22 @@ void CDockOverlay::paintEvent(QPaintEvent* event)
 {
 	Q_UNUSED(event);
 
+	auto DockManager = qobject_cast<CDockManager*>(parentWidget());
+	if (DockManager)
+	{
+		DockManager->hitTestIndex()->recordOverlayRepaint();
+	}
+
 	// Draw rect based on location
 	if (!d->DropPreviewEnabled)
 	{
-		d->DropAreaRect = QRect();
 		return;
 	}
 
-	QRect r = rect();
-	const DockWidgetArea da = dropAreaUnderCursor();
-	double Factor = (CDockOverlay::ModeContainerOverlay == d->Mode) ?
-		3 : 2;
-
-	switch (da)
+	QRect r = d->dropAreaRect(dropAreaUnderCursor());
+	if (!r.isValid())
 	{
-    case TopDockWidgetArea: r.setHeight(r.height() / Factor); break;
-	case RightDockWidgetArea: r.setX(r.width() * (1 - 1 / Factor)); break;
-	case BottomDockWidgetArea: r.setY(r.height() * (1 - 1 / Factor)); break;
-	case LeftDockWidgetArea: r.setWidth(r.width() / Factor); break;
-	case CenterDockWidgetArea: r = rect();break;
-	case LeftAutoHideArea: r.setWidth(d->sideBarOverlaySize(SideBarLeft)); break;
-	case RightAutoHideArea: r.setX(r.width() - d->sideBarOverlaySize(SideBarRight)); break;
-	case TopAutoHideArea: r.setHeight(d->sideBarOverlaySize(SideBarTop)); break;
-	case BottomAutoHideArea: r.setY(r.height() - d->sideBarOverlaySize(SideBarBottom)); break;
-	default: return;
+		return;
 	}
 
 	QPainter painter(this);
@@ -647,14 +769,18 @@ void CDockOverlay::paintEvent(QPaintEvent* event)
     Color.setAlpha(64);
     painter.setBrush(Color);
 	painter.drawRect(r.adjusted(0, 0, -1, -1));
-	d->DropAreaRect = r;
 }
 
 
 //============================================================================
 QRect CDockOverlay::dropOverlayRect() const
 {
-	return d->DropAreaRect;
+	if (isHidden() || !d->DropPreviewEnabled)
+	{
+		return QRect();
+	}
+
+	return d->dropAreaRect(dropAreaUnderCursor());
 }
 
 
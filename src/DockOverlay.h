@@ -83,7 +83,9 @@ public:
 	DockWidgetAreas allowedAreas() const;
 
 	/**
-	 * Returns the drop area under the current cursor location
+	 * Returns the drop area under the current cursor location.
+	 * The drop area is only computed again if the cursor position or the
+	 * overlay geometry changed.
 	 */
 	DockWidgetArea dropAreaUnderCursor() const;
 
@@ -127,7 +129,8 @@ public:
 	bool dropPreviewEnabled() const;
 
 	/**
-	 * The drop overlay rectangle for the target area
+	 * The drop overlay rectangle for the target area or an invalid rectangle
+	 * if the overlay is hidden or if there is no drop area under the cursor
 	 */
 	QRect dropOverlayRect() const;
 
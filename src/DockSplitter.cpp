@@ -33,6 +33,7 @@
 #include <QChildEvent>
 #include <QVariant>
 #include "DockAreaWidget.h"
+#include "DockContainerWidget.h"
 
 namespace ads
 {
@@ -73,6 +74,21 @@ CDockSplitter::~CDockSplitter()
 }
 
 
+//============================================================================
+void CDockSplitter::resizeEvent(QResizeEvent* event)
+{
+	// Resizing the splitter changes the sizes stored in the container state.
+	// The splitter may be moved into another container, so we look up the
+	// container on each resize
+	auto DockContainer = internal::findParent<CDockContainerWidget*>(this);
+	if (DockContainer)
+	{
+		DockContainer->markStateDirty();
+	}
+	QSplitter::resizeEvent(event);
+}
+
+
 //============================================================================
 bool CDockSplitter::hasVisibleContent() const
 {
@@ -48,6 +48,12 @@ private:
 	DockSplitterPrivate* d;
 	friend struct DockSplitterPrivate;
 
+protected:
+	/**
+	 * Marks the state of the parent dock container as changed
+	 */
+	virtual void resizeEvent(QResizeEvent* event) override;
+
 public:
 	CDockSplitter(QWidget *parent = Q_NULLPTR);
 	CDockSplitter(Qt::Orientation orientation, QWidget *parent = Q_NULLPTR);
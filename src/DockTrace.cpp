@@ -0,0 +1,214 @@
+//============================================================================
+/// \file   DockTrace.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Implementation of CDockTrace class
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockTrace.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+namespace ads
+{
+/**
+ * A single recorded span
+ */
+struct TraceSpan
+{
+	const char* Name;
+	const char* Category;
+	qint64 StartNs;
+	qint64 DurationNs;
+	quintptr ThreadId;
+};
+
+/**
+ * Global trace data that is shared by all threads
+ */
+struct DockTraceData
+{
+	QMutex Mutex;
+	QVector<TraceSpan> Spans;
+	int MaxSpanCount = 1000000;
+	int DroppedSpanCount = 0;
+	QElapsedTimer Clock;
+
+	DockTraceData()
+	{
+		Clock.start();
+	}
+};
+
+
+//============================================================================
+static DockTraceData& traceData()
+{
+	static DockTraceData Data;
+	return Data;
+}
+
+
+std::atomic<bool> CDockTrace::s_Enabled(false);
+
+
+//============================================================================
+void CDockTrace::setEnabled(bool Enabled)
+{
+	// Ensure that the clock is started before the first span is recorded
+	traceData();
+	s_Enabled.store(Enabled, std::memory_order_relaxed);
+}
+
+
+//============================================================================
+void CDockTrace::setMaxSpanCount(int Count)
+{
+	auto& Data = traceData();
+	QMutexLocker Lock(&Data.Mutex);
+	Data.MaxSpanCount = qMax(0, Count);
+}
+
+
+//============================================================================
+int CDockTrace::maxSpanCount()
+{
+	auto& Data = traceData();
+	QMutexLocker Lock(&Data.Mutex);
+	return Data.MaxSpanCount;
+}
+
+
+//============================================================================
+int CDockTrace::spanCount()
+{
+	auto& Data = traceData();
+	QMutexLocker Lock(&Data.Mutex);
+	return Data.Spans.count();
+}
+
+
+//============================================================================
+int CDockTrace::droppedSpanCount()
+{
+	auto& Data = traceData();
+	QMutexLocker Lock(&Data.Mutex);
+	return Data.DroppedSpanCount;
+}
+
+
+//============================================================================
+void CDockTrace::clear()
+{
+	auto& Data = traceData();
+	QMutexLocker Lock(&Data.Mutex);
+	Data.Spans.clear();
+	Data.DroppedSpanCount = 0;
+}
+
+
+//============================================================================
+qint64 CDockTrace::timestamp()
+{
+	return traceData().Clock.nsecsElapsed();
+}
+
+
+//============================================================================
+void CDockTrace::addSpan(const char* Name, const char* Category,
+	qint64 StartNs, qint64 DurationNs)
+{
+	auto& Data = traceData();
+	auto ThreadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+	QMutexLocker Lock(&Data.Mutex);
+	if (Data.Spans.count() >= Data.MaxSpanCount)
+	{
+		Data.DroppedSpanCount++;
+		return;
+	}
+	Data.Spans.append(TraceSpan{Name, Category, StartNs, DurationNs, ThreadId});
+}
+
+
+//============================================================================
+QByteArray CDockTrace::toChromeTraceJson()
+{
+	QVector<TraceSpan> Spans;
+	{
+		auto& Data = traceData();
+		QMutexLocker Lock(&Data.Mutex);
+		Spans = Data.Spans;
+	}
+
+	// The trace viewers expect small thread ids, so we number the threads
+	// in the order of their first appearance
+	QHash<quintptr, int> ThreadIds;
+	const qint64 Pid = QCoreApplication::applicationPid();
+	QJsonArray Events;
+	for (const auto& Span : Spans)
+	{
+		auto ThreadIt = ThreadIds.find(Span.ThreadId);
+		if (ThreadIt == ThreadIds.end())
+		{
+			ThreadIt = ThreadIds.insert(Span.ThreadId, ThreadIds.count() + 1);
+		}
+
+		QJsonObject Event;
+		Event["name"] = QString::fromUtf8(Span.Name);
+		Event["cat"] = QString::fromUtf8(Span.Category);
+		Event["ph"] = QStringLiteral("X");
+		Event["ts"] = Span.StartNs / 1000.0;
+		Event["dur"] = Span.DurationNs / 1000.0;
+		Event["pid"] = Pid;
+		Event["tid"] = ThreadIt.value();
+		Events.append(Event);
+	}
+
+	QJsonObject Trace;
+	Trace["traceEvents"] = Events;
+	Trace["displayTimeUnit"] = QStringLiteral("ms");
+	return QJsonDocument(Trace).toJson(QJsonDocument::Compact);
+}
+
+
+//============================================================================
+bool CDockTrace::writeChromeTrace(QIODevice* Device)
+{
+	if (!Device)
+	{
+		return false;
+	}
+
+	auto Json = toChromeTraceJson();
+	return Device->write(Json) == Json.size();
+}
+
+
+//============================================================================
+bool CDockTrace::writeChromeTrace(const QString& FileName)
+{
+	QFile File(FileName);
+	if (!File.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		return false;
+	}
+
+	return writeChromeTrace(&File);
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockTrace.cpp
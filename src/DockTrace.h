@@ -0,0 +1,164 @@
+#ifndef DockTraceH
+#define DockTraceH
+//============================================================================
+/// \file   DockTrace.h
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Declaration of CDockTrace class
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <atomic>
+
+#include <QByteArray>
+#include <QString>
+
+#include "ads_globals.h"
+
+QT_FORWARD_DECLARE_CLASS(QIODevice)
+
+namespace ads
+{
+/**
+ * Lightweight tracing of the expensive docking operations like restoring
+ * the state, dragging of floating widgets or repolishing of styles.
+ * Tracing is compiled into all builds and is switched on at runtime. If
+ * tracing is disabled, a trace span only costs a single relaxed atomic
+ * load. The recorded spans can be exported in the Chrome trace event
+ * JSON format that can be loaded into chrome://tracing or
+ * https://ui.perfetto.dev.
+ * Setting the environment variable ADS_TRACE_FILE to a file name enables
+ * tracing when the dock manager is created and writes the trace file when
+ * the dock manager is destroyed.
+ */
+class ADS_EXPORT CDockTrace
+{
+public:
+	/**
+	 * Scoped trace span. The span records the time from its construction
+	 * until its destruction. Name and category need to be string literals
+	 * or strings that outlive the recorded trace.
+	 */
+	class ADS_EXPORT Span
+	{
+	private:
+		const char* m_Name;
+		const char* m_Category;
+		qint64 m_StartNs;
+
+	public:
+		Span(const char* Name, const char* Category = "ads")
+			: m_Name(Name), m_Category(Category),
+			  m_StartNs(CDockTrace::isEnabled() ? CDockTrace::timestamp() : -1)
+		{
+		}
+
+		~Span()
+		{
+			if (m_StartNs >= 0)
+			{
+				CDockTrace::addSpan(m_Name, m_Category, m_StartNs,
+					CDockTrace::timestamp() - m_StartNs);
+			}
+		}
+
+	private:
+		Span(const Span&);
+		Span& operator=(const Span&);
+	};
+
+	/**
+	 * Enables or disables tracing. Enabling the tracing does not clear the
+	 * already recorded spans.
+	 */
+	static void setEnabled(bool Enabled);
+
+	/**
+	 * Returns true, if tracing is enabled
+	 */
+	static bool isEnabled()
+	{
+		return s_Enabled.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Sets the maximum number of recorded spans. If the limit is reached,
+	 * further spans are dropped. The default is 1000000 spans.
+	 */
+	static void setMaxSpanCount(int Count);
+
+	/**
+	 * Returns the maximum number of recorded spans
+	 */
+	static int maxSpanCount();
+
+	/**
+	 * Returns the number of recorded spans
+	 */
+	static int spanCount();
+
+	/**
+	 * Returns the number of spans that have been dropped because the
+	 * maximum span count has been reached
+	 */
+	static int droppedSpanCount();
+
+	/**
+	 * Removes all recorded spans
+	 */
+	static void clear();
+
+	/**
+	 * Returns the monotonic trace clock in nanoseconds
+	 */
+	static qint64 timestamp();
+
+	/**
+	 * Records a complete span. Normally you should use a Span object or
+	 * the ADS_TRACE_SCOPE macro instead of calling this function directly
+	 */
+	static void addSpan(const char* Name, const char* Category,
+		qint64 StartNs, qint64 DurationNs);
+
+	/**
+	 * Returns the recorded spans in the Chrome trace event JSON format
+	 */
+	static QByteArray toChromeTraceJson();
+
+	/**
+	 * Writes the recorded spans in the Chrome trace event JSON format into
+	 * the given device
+	 */
+	static bool writeChromeTrace(QIODevice* Device);
+
+	/**
+	 * Writes the recorded spans in the Chrome trace event JSON format into
+	 * the file with the given name
+	 */
+	static bool writeChromeTrace(const QString& FileName);
+
+private:
+	static std::atomic<bool> s_Enabled;
+};
+} // namespace ads
+
+#define ADS_TRACE_CONCAT_IMPL(a, b) a##b
+#define ADS_TRACE_CONCAT(a, b) ADS_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * Records a trace span for the remainder of the current scope
+ */
+#define ADS_TRACE_SCOPE(Name) \
+	ads::CDockTrace::Span ADS_TRACE_CONCAT(AdsTraceSpan, __LINE__)(Name)
+
+/**
+ * Records a trace span with the given category for the remainder of the
+ * current scope
+ */
+#define ADS_TRACE_SCOPE_CATEGORY(Name, Category) \
+	ads::CDockTrace::Span ADS_TRACE_CONCAT(AdsTraceSpan, __LINE__)(Name, Category)
+
+//---------------------------------------------------------------------------
+#endif // DockTraceH
@@ -44,10 +44,12 @@
 #include <QTextStream>
 #include <QPointer>
 #include <QEvent>
+#include <QElapsedTimer>
 #include <QDebug>
 #include <QToolBar>
 #include <QXmlStreamWriter>
 #include <QWindow>
+#include <QAtomicInt>
 
 #include <QGuiApplication>
 #include <QScreen>
@@ -59,11 +61,19 @@
 #include "FloatingDockContainer.h"
 #include "DockSplitter.h"
 #include "DockComponentsFactory.h"
+#include "DockingStateReader.h"
+#include "DockingStateWriter.h"
 #include "ads_globals.h"
 
 
 namespace ads
 {
+/**
+ * Source of the dock widget handles. Handles start at 1 and are never
+ * reused during the lifetime of the application.
+ */
+static QAtomicInt NextDockWidgetHandle(1);
+
 /**
  * Private data class of CDockWidget class (pimpl)
  */
@@ -96,6 +106,12 @@ struct DockWidgetPrivate
 	WidgetFactory* Factory = nullptr;
 	QPointer<CAutoHideTab> SideTabWidget;
 	CDockWidget::eToolBarStyleSource ToolBarStyleSource = CDockWidget::ToolBarStyleFromDockManager;
+	CDockWidget::ContentStateSaveFunc SaveContentState;
+	CDockWidget::ContentStateRestoreFunc RestoreContentState;
+	QVariant ContentState;
+	int ContentCost = 1;
+	QElapsedTimer InactiveTimer;
+	int Handle = 0;
 	
 	/**
 	 * Private data constructor
@@ -149,6 +165,26 @@ struct DockWidgetPrivate
 	 */
 	bool createWidgetFromFactory();
 
+	/**
+	 * Returns true, if the content widget is created deferred and has not
+	 * been created yet
+	 */
+	bool hasDeferredContent() const
+	{
+		return !Widget && Factory && Features.testFlag(CDockWidget::DeferredContent);
+	}
+
+	/**
+	 * Creates the deferred content widget when the dock widget becomes
+	 * visible
+	 */
+	void createDeferredContent();
+
+	/**
+	 * Deletes the content widget and its scroll area
+	 */
+	void deleteContentWidget();
+
 	/**
 	 * Use the dock manager toolbar style and icon size for the different states
 	 */
@@ -158,16 +194,19 @@ struct DockWidgetPrivate
 
 //============================================================================
 DockWidgetPrivate::DockWidgetPrivate(CDockWidget* _public) :
-	_this(_public)
+	_this(_public),
+	Handle(NextDockWidgetHandle.fetchAndAddRelaxed(1))
 {
-
+	InactiveTimer.start();
 }
 
 
 //============================================================================
 void DockWidgetPrivate::showDockWidget()
 {
-	if (!Widget)
+	// Deferred content is created as soon as the dock widget is really
+	// visible and not when it is opened in a hidden dock area or tab
+	if (!Widget && !hasDeferredContent())
 	{
 		if (!createWidgetFromFactory())
 		{
@@ -225,20 +264,27 @@ void DockWidgetPrivate::hideDockWidget()
 
 	closeAutoHideDockWidgetsIfNeeded();
 
-	if (Features.testFlag(CDockWidget::DeleteContentOnClose))
+	if (Features.testFlag(CDockWidget::DeleteContentOnClose) && Widget)
 	{
-		if (ScrollArea)
-		{
-			ScrollArea->takeWidget();
-			delete ScrollArea;
-			ScrollArea = nullptr;
-		}
-		Widget->deleteLater();
-		Widget = nullptr;
+		deleteContentWidget();
 	}
 }
 
 
+//============================================================================
+void DockWidgetPrivate::deleteContentWidget()
+{
+	if (ScrollArea)
+	{
+		ScrollArea->takeWidget();
+		delete ScrollArea;
+		ScrollArea = nullptr;
+	}
+	Widget->deleteLater();
+	Widget = nullptr;
+}
+
+
 //============================================================================
 void DockWidgetPrivate::updateParentDockArea()
 {
@@ -327,7 +373,8 @@ void DockWidgetPrivate::setupScrollArea()
 //============================================================================
 bool DockWidgetPrivate::createWidgetFromFactory()
 {
-	if (!Features.testFlag(CDockWidget::DeleteContentOnClose)) 
+	if (!Features.testFlag(CDockWidget::DeleteContentOnClose)
+	 && !Features.testFlag(CDockWidget::DeferredContent))
 	{
 		return false;
 	}
@@ -344,10 +391,46 @@ bool DockWidgetPrivate::createWidgetFromFactory()
 	}
 	
 	_this->setWidget(w, Factory->insertMode);
+	if (ContentState.isValid())
+	{
+		if (RestoreContentState)
+		{
+			RestoreContentState(w, ContentState);
+		}
+		ContentState = QVariant();
+	}
 	return true;
 }
 
 
+//============================================================================
+void DockWidgetPrivate::createDeferredContent()
+{
+	if (!hasDeferredContent() || !createWidgetFromFactory())
+	{
+		return;
+	}
+
+	// Creating content may exceed the content budget of the dock manager
+	if (DockManager && DockManager->contentBudget() > 0)
+	{
+		QMetaObject::invokeMethod(DockManager, "releaseInactiveContents", Qt::QueuedConnection);
+	}
+
+	// We are inside of the show event here, so the new content needs to
+	// be shown explicitly - otherwise it would appear one event loop
+	// iteration later
+	if (ScrollArea)
+	{
+		ScrollArea->show();
+	}
+	else
+	{
+		Widget->show();
+	}
+}
+
+
 //============================================================================
 void DockWidgetPrivate::setToolBarStyleFromDockManager()
 {
@@ -687,6 +770,75 @@ bool CDockWidget::isClosed() const
 }
 
 
+//============================================================================
+bool CDockWidget::hasDeferredContent() const
+{
+	return d->hasDeferredContent();
+}
+
+
+//============================================================================
+bool CDockWidget::isContentReleasable() const
+{
+	return d->Widget && d->Factory && d->Features.testFlag(DeferredContent);
+}
+
+
+//============================================================================
+qint64 CDockWidget::inactiveTime() const
+{
+	return d->InactiveTimer.elapsed();
+}
+
+
+//============================================================================
+void CDockWidget::setContentStateHandlers(ContentStateSaveFunc SaveState,
+	ContentStateRestoreFunc RestoreState)
+{
+	d->SaveContentState = SaveState;
+	d->RestoreContentState = RestoreState;
+}
+
+
+//============================================================================
+void CDockWidget::setContentCost(int Cost)
+{
+	d->ContentCost = Cost;
+}
+
+
+//============================================================================
+int CDockWidget::contentCost() const
+{
+	return d->ContentCost;
+}
+
+
+//============================================================================
+int CDockWidget::handle() const
+{
+	return d->Handle;
+}
+
+
+//============================================================================
+bool CDockWidget::releaseContent()
+{
+	if (!isContentReleasable() || isVisible())
+	{
+		return false;
+	}
+
+	ADS_PRINT("CDockWidget::releaseContent " << objectName());
+	if (d->SaveContentState)
+	{
+		d->ContentState = d->SaveContentState(d->Widget);
+	}
+	d->deleteContentWidget();
+	return true;
+}
+
+
 //============================================================================
 QAction* CDockWidget::toggleViewAction() const
 {
@@ -770,6 +922,10 @@ void CDockWidget::toggleViewInternal(bool Open)
 		? DockContainer->topLevelDockWidget() : nullptr;
 
 	d->Closed = !Open;
+	if (DockContainer)
+	{
+		DockContainer->markStateDirty();
+	}
 
 	if (Open)
 	{
@@ -831,10 +987,18 @@ void CDockWidget::setDockArea(CDockAreaWidget* DockArea)
 //============================================================================
 void CDockWidget::saveState(QXmlStreamWriter& s) const
 {
-	s.writeStartElement("Widget");
-	s.writeAttribute("Name", objectName());
-	s.writeAttribute("Closed", QString::number(d->Closed ? 1 : 0));
-	s.writeEndElement();
+	DockWidgetState State;
+	saveState(State);
+	CDockingStateWriter::writeDockWidget(s, State, false);
+}
+
+
+//============================================================================
+void CDockWidget::saveState(DockWidgetState& State) const
+{
+	State.Name = objectName();
+	State.Handle = d->Handle;
+	State.Closed = d->Closed;
 }
 
 
@@ -855,10 +1019,13 @@ bool CDockWidget::event(QEvent *e)
 	switch (e->type())
 	{
 	case QEvent::Hide:
+		d->InactiveTimer.restart();
 		Q_EMIT visibilityChanged(false);
 		break;
 
 	case QEvent::Show:
+		d->InactiveTimer.restart();
+		d->createDeferredContent();
 		Q_EMIT visibilityChanged(geometry().right() >= 0 && geometry().bottom() >= 0);
 		break;
 
@@ -1073,6 +1240,12 @@ void CDockWidget::emitTopLevelEventForWidget(CDockWidget* TopLevelDockWidget, bo
 //============================================================================
 void CDockWidget::emitTopLevelChanged(bool Floating)
 {
+	// Deferred until CDockManager::endLayoutUpdate()
+	if (d->DockManager && d->DockManager->isLayoutUpdateActive())
+	{
+		return;
+	}
+
 	if (Floating != d->IsFloatingTopLevel)
 	{
 		d->IsFloatingTopLevel = Floating;
@@ -1084,6 +1257,10 @@ void CDockWidget::emitTopLevelChanged(bool Floating)
 //============================================================================
 void CDockWidget::setClosedState(bool Closed)
 {
+	if (d->Closed != Closed && dockContainer())
+	{
+		dockContainer()->markStateDirty();
+	}
 	d->Closed = Closed;
 }
 
@@ -31,6 +31,7 @@
 //                                   INCLUDES
 //============================================================================
 #include <QFrame>
+#include <QVariant>
 
 #include "ads_globals.h"
 
@@ -40,6 +41,7 @@ QT_FORWARD_DECLARE_CLASS(QXmlStreamWriter)
 namespace ads
 {
 struct DockWidgetPrivate;
+struct DockWidgetState;
 class CDockWidgetTab;
 class CDockManager;
 class CDockContainerWidget;
@@ -105,6 +107,11 @@ protected:
      */
     void saveState(QXmlStreamWriter& Stream) const;
 
+    /**
+     * Saves the state into the given state tree entry
+     */
+    void saveState(DockWidgetState& State) const;
+
     /**
      * This is a helper function for the dock manager to flag this widget
      * as unassigned.
@@ -141,6 +148,18 @@ protected:
      */
     void toggleViewInternal(bool Open);
 
+    /**
+     * Returns true, if the content widget exists and can be released and
+     * rebuilt later by the widget factory
+     */
+    bool isContentReleasable() const;
+
+    /**
+     * Returns the time in milliseconds since the dock widget has been shown
+     * or hidden the last time
+     */
+    qint64 inactiveTime() const;
+
     /**
      * Internal close dock widget implementation.
      * The function returns true if the dock widget has been closed or hidden
@@ -162,6 +181,7 @@ public:
         NoTab = 0x080, ///< dock widget tab will never be shown if this flag is set
         DeleteContentOnClose = 0x100, ///< deletes only the contained widget on close, keeping the dock widget intact and in place. Attempts to rebuild the contents widget on show if there is a widget factory set.
         DockWidgetPinnable = 0x200, ///< dock widget can be pinned and added to an auto hide dock container
+        DeferredContent = 0x400, ///< the content widget is created by the widget factory when the dock widget is shown for the first time
         DefaultDockWidgetFeatures = DockWidgetClosable | DockWidgetMovable | DockWidgetFloatable | DockWidgetFocusable | DockWidgetPinnable,
         AllDockWidgetFeatures = DefaultDockWidgetFeatures | DockWidgetDeleteOnClose | CustomCloseHandling,
         DockWidgetAlwaysCloseAndDelete = DockWidgetForceCloseWithArea | DockWidgetDeleteOnClose,
@@ -317,16 +337,63 @@ public:
     void setWidget(QWidget* widget, eInsertMode InsertMode = AutoScrollArea);
 	
 	/**
-	 * Only used when the feature flag DeleteContentOnClose is set.
+	 * Only used when the feature flag DeleteContentOnClose or DeferredContent
+	 * is set.
 	 * Using the flag and setting a widget factory allows to free the resources
 	 * of the widget of your application while retaining the position the next
 	 * time you want to show your widget, unlike the flag DockWidgetDeleteOnClose
 	 * which deletes the dock widget itself. Since we keep the dock widget, all
 	 * regular features of ADS should work as normal, including saving and
 	 * restoring the state of the docking system and using perspectives.
+	 * If DeferredContent is set, the factory is not called before the dock
+	 * widget becomes visible for the first time, i.e. if it becomes the
+	 * current tab of a visible dock area. Until then widget() returns a
+	 * nullptr.
 	 */
 	using FactoryFunc = std::function<QWidget*(QWidget*)>;
 	void setWidgetFactory(FactoryFunc createWidget, eInsertMode InsertMode = AutoScrollArea);
+
+	/**
+	 * Optional handlers to keep the internal state of the content widget
+	 * if the content is released by releaseContent() and rebuilt by the
+	 * widget factory later. The save function is called before the content
+	 * is deleted and the restore function is called with the saved value
+	 * after the factory created the new content widget.
+	 */
+	using ContentStateSaveFunc = std::function<QVariant(QWidget*)>;
+	using ContentStateRestoreFunc = std::function<void(QWidget*, const QVariant&)>;
+	void setContentStateHandlers(ContentStateSaveFunc SaveState,
+		ContentStateRestoreFunc RestoreState);
+
+	/**
+	 * Sets the cost of the content widget that is used for the content
+	 * budget of the dock manager - i.e. the estimated memory in MB.
+	 * The default cost is 1.
+	 * \see CDockManager::setContentBudget()
+	 */
+	void setContentCost(int Cost);
+
+	/**
+	 * Returns the content cost
+	 */
+	int contentCost() const;
+
+	/**
+	 * Returns the handle of this dock widget. The handle is a positive
+	 * integer that is unique for all dock widgets created in this
+	 * application session and never changes, even if the dock widget is
+	 * renamed. The handle is not persistent across sessions.
+	 * \see CDockManager::findDockWidget(int)
+	 */
+	int handle() const;
+
+	/**
+	 * Releases the content widget of an invisible dock widget with the
+	 * DeferredContent feature and a widget factory. The content is rebuilt
+	 * by the factory the next time the dock widget becomes visible.
+	 * Returns true, if the content has been released.
+	 */
+	bool releaseContent();
 	
     /**
      * Remove the widget from the dock and give ownership back to the caller
@@ -442,6 +509,12 @@ public:
      */
     bool isClosed() const;
 
+    /**
+     * Returns true, if the DeferredContent feature is set and the content
+     * widget has not been created by the widget factory yet
+     */
+    bool hasDeferredContent() const;
+
     /**
      * Returns a checkable action that can be used to show or close this dock widget.
      * The action's text is set to the dock widget's window title.
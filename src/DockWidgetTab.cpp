@@ -309,7 +309,7 @@ bool DockWidgetTabPrivate::startFloating(eDragState DraggingState)
 	// then it does not make any sense, to make it floating because
 	// it is already floating
 	 if (dockContainer->isFloating()
-	 && (dockContainer->visibleDockAreaCount() == 1)
+	 && (dockContainer->layoutStatistics().VisibleDockAreas == 1)
 	 && (DockWidget->dockAreaWidget()->dockWidgetsCount() == 1))
 	{
 		return false;
@@ -482,7 +482,7 @@ void CDockWidgetTab::mouseMoveEvent(QMouseEvent* ev)
     	// floating widget and leave this one empty
 		if (d->DockArea->dockContainer()->isFloating()
 		 && d->DockArea->openDockWidgetsCount() == 1
-		 && d->DockArea->dockContainer()->visibleDockAreaCount() == 1)
+		 && d->DockArea->dockContainer()->layoutStatistics().VisibleDockAreas == 1)
 		{
 			return;
 		}
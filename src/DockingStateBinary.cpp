@@ -0,0 +1,443 @@
+//============================================================================
+/// \file   DockingStateBinary.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Implementation of CDockingStateBinary
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockingStateBinary.h"
+#include "DockManager.h"
+
+#include <QHash>
+
+#include <cstring>
+
+namespace ads
+{
+static const char BinaryMagic[] = {'A', 'D', 'S', 'B'};
+static const int BinaryMagicSize = sizeof(BinaryMagic);
+static const quint8 BinaryFormatVersion = 1;
+
+
+/**
+ * Appends the binary encoding to a byte array and interns all strings
+ */
+class CBinaryStateWriter
+{
+public:
+	QByteArray Data;
+	QHash<QString, int> StringIndices;
+	QVector<QString> Strings;
+
+	void writeByte(quint8 Value)
+	{
+		Data.append(char(Value));
+	}
+
+	void writeVarint(quint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Data.append(char((Value & 0x7f) | 0x80));
+			Value >>= 7;
+		}
+		Data.append(char(Value));
+	}
+
+	/**
+	 * Writes a value that may be -1 as varint, shifted by one
+	 */
+	void writeOptional(int Value)
+	{
+		writeVarint(quint32(Value + 1));
+	}
+
+	void writeSigned(int Value)
+	{
+		writeVarint((quint32(Value) << 1) ^ quint32(Value >> 31));
+	}
+
+	void writeBytes(const QByteArray& Bytes)
+	{
+		writeVarint(quint32(Bytes.size()));
+		Data.append(Bytes);
+	}
+
+	/**
+	 * Returns the index of the given string in the string table
+	 */
+	int intern(const QString& String)
+	{
+		auto it = StringIndices.constFind(String);
+		if (it != StringIndices.constEnd())
+		{
+			return it.value();
+		}
+		int Index = Strings.count();
+		StringIndices.insert(String, Index);
+		Strings.append(String);
+		return Index;
+	}
+
+	void writeDockWidget(const DockWidgetState& DockWidget, bool WriteSize)
+	{
+		writeVarint(quint32(intern(DockWidget.Name)));
+		writeByte(DockWidget.Closed ? 1 : 0);
+		if (WriteSize)
+		{
+			writeSigned(DockWidget.Size);
+		}
+	}
+
+	void writeNode(const LayoutNodeState& Node)
+	{
+		writeByte(quint8(Node.Type));
+		if (LayoutNodeState::Splitter == Node.Type)
+		{
+			writeByte(Node.Orientation == Qt::Horizontal ? 0 : 1);
+			writeVarint(quint32(Node.Children.count()));
+			for (auto Child : Node.Children)
+			{
+				writeVarint(quint32(Child));
+			}
+			writeVarint(quint32(Node.Sizes.count()));
+			for (auto Size : Node.Sizes)
+			{
+				writeSigned(Size);
+			}
+		}
+		else
+		{
+			writeOptional(Node.CurrentDockWidget.isEmpty() ? -1 : intern(Node.CurrentDockWidget));
+			writeOptional(Node.AllowedAreas);
+			writeOptional(Node.Flags);
+			writeVarint(quint32(Node.DockWidgets.count()));
+			for (const auto& DockWidget : Node.DockWidgets)
+			{
+				writeDockWidget(DockWidget, false);
+			}
+		}
+	}
+
+	void writeContainer(const DockContainerState& Container)
+	{
+		writeByte(Container.Floating ? 1 : 0);
+		if (Container.Floating)
+		{
+			writeBytes(Container.Geometry);
+		}
+		writeVarint(quint32(Container.Nodes.count()));
+		for (const auto& Node : Container.Nodes)
+		{
+			writeNode(Node);
+		}
+		writeOptional(Container.RootNode);
+		writeVarint(quint32(Container.SideBars.count()));
+		for (const auto& SideBar : Container.SideBars)
+		{
+			writeByte(quint8(SideBar.Area));
+			writeVarint(quint32(SideBar.DockWidgets.count()));
+			for (const auto& DockWidget : SideBar.DockWidgets)
+			{
+				writeDockWidget(DockWidget, true);
+			}
+		}
+	}
+};
+
+
+/**
+ * Bounds checked reader for the binary encoding. After the first error all
+ * read functions return 0 and hasError() returns true.
+ */
+class CBinaryStateReader
+{
+public:
+	const char* Pos;
+	const char* End;
+	bool Error = false;
+	QVector<QString> Strings;
+
+	CBinaryStateReader(const QByteArray& Data)
+		: Pos(Data.constData()), End(Data.constData() + Data.size())
+	{}
+
+	bool hasError() const {return Error;}
+
+	quint8 readByte()
+	{
+		if (Error || Pos >= End)
+		{
+			Error = true;
+			return 0;
+		}
+		return quint8(*Pos++);
+	}
+
+	quint32 readVarint()
+	{
+		quint32 Value = 0;
+		for (int Shift = 0; Shift < 35; Shift += 7)
+		{
+			quint8 Byte = readByte();
+			Value |= quint32(Byte & 0x7f) << Shift;
+			if (!(Byte & 0x80))
+			{
+				return Value;
+			}
+		}
+		Error = true;
+		return 0;
+	}
+
+	int readOptional()
+	{
+		return int(readVarint()) - 1;
+	}
+
+	int readSigned()
+	{
+		quint32 Value = readVarint();
+		return int(Value >> 1) ^ -int(Value & 1);
+	}
+
+	/**
+	 * Reads a count and checks that there are at least Count * MinItemSize
+	 * bytes left, so corrupt data never triggers huge allocations
+	 */
+	int readCount(int MinItemSize = 1)
+	{
+		quint32 Count = readVarint();
+		if (Error || Count > quint32(End - Pos) / quint32(MinItemSize))
+		{
+			Error = true;
+			return 0;
+		}
+		return int(Count);
+	}
+
+	QByteArray readBytes()
+	{
+		int Size = readCount();
+		if (Error)
+		{
+			return QByteArray();
+		}
+		QByteArray Bytes(Pos, Size);
+		Pos += Size;
+		return Bytes;
+	}
+
+	QString readString(int Index)
+	{
+		if (Index < 0 || Index >= Strings.count())
+		{
+			Error = true;
+			return QString();
+		}
+		return Strings.at(Index);
+	}
+
+	void readDockWidget(DockWidgetState& DockWidget, bool ReadSize)
+	{
+		DockWidget.Name = readString(int(readVarint()));
+		DockWidget.Closed = readByte() != 0;
+		if (ReadSize)
+		{
+			DockWidget.Size = readSigned();
+		}
+	}
+
+	void readNode(LayoutNodeState& Node, int NodeIndex)
+	{
+		quint8 Type = readByte();
+		if (LayoutNodeState::Splitter == Type)
+		{
+			Node.Type = LayoutNodeState::Splitter;
+			Node.Orientation = readByte() ? Qt::Vertical : Qt::Horizontal;
+			int Count = readCount();
+			Node.Children.reserve(Count);
+			for (int i = 0; i < Count; ++i)
+			{
+				// Nodes are stored in post-order so every child must have
+				// been read before its parent
+				int Child = int(readVarint());
+				if (Child >= NodeIndex)
+				{
+					Error = true;
+					return;
+				}
+				Node.Children.append(Child);
+			}
+			// Like the XML reader we require one size per child
+			Count = readCount();
+			if (Count != Node.Children.count())
+			{
+				Error = true;
+				return;
+			}
+			Node.Sizes.reserve(Count);
+			for (int i = 0; i < Count; ++i)
+			{
+				Node.Sizes.append(readSigned());
+			}
+		}
+		else if (LayoutNodeState::Area == Type)
+		{
+			Node.Type = LayoutNodeState::Area;
+			int Current = readOptional();
+			if (Current >= 0)
+			{
+				Node.CurrentDockWidget = readString(Current);
+			}
+			Node.AllowedAreas = readOptional();
+			Node.Flags = readOptional();
+			int Count = readCount(2);
+			Node.DockWidgets.resize(Count);
+			for (auto& DockWidget : Node.DockWidgets)
+			{
+				readDockWidget(DockWidget, false);
+			}
+		}
+		else
+		{
+			Error = true;
+		}
+	}
+
+	void readContainer(DockContainerState& Container)
+	{
+		Container.Floating = readByte() != 0;
+		if (Container.Floating)
+		{
+			// Like the XML reader we require the geometry of floating widgets
+			Container.Geometry = readBytes();
+			if (Container.Geometry.isEmpty())
+			{
+				Error = true;
+				return;
+			}
+		}
+		int Count = readCount();
+		Container.Nodes.resize(Count);
+		for (int i = 0; i < Count && !Error; ++i)
+		{
+			readNode(Container.Nodes[i], i);
+		}
+		Container.RootNode = readOptional();
+		if (Container.RootNode >= Count)
+		{
+			Error = true;
+			return;
+		}
+		Count = readCount(2);
+		Container.SideBars.resize(Count);
+		for (auto& SideBar : Container.SideBars)
+		{
+			int Area = readByte();
+			if (Area < SideBarTop || Area > SideBarBottom)
+			{
+				Error = true;
+				return;
+			}
+			SideBar.Area = SideBarLocation(Area);
+			int WidgetCount = readCount(3);
+			SideBar.DockWidgets.resize(WidgetCount);
+			for (auto& DockWidget : SideBar.DockWidgets)
+			{
+				readDockWidget(DockWidget, true);
+			}
+		}
+
+		// Simply ignore side bar auto hide widgets from saved state if
+		// auto hide support is disabled
+		if (!CDockManager::testAutoHideConfigFlag(CDockManager::AutoHideFeatureEnabled))
+		{
+			Container.SideBars.clear();
+		}
+	}
+};
+
+
+//============================================================================
+bool CDockingStateBinary::isBinary(const QByteArray& Data)
+{
+	return Data.size() > BinaryMagicSize
+		&& memcmp(Data.constData(), BinaryMagic, BinaryMagicSize) == 0;
+}
+
+
+//============================================================================
+QByteArray CDockingStateBinary::write(const DockingState& State)
+{
+	// The body is encoded first to collect the interned strings, then the
+	// header and the string table are prepended
+	CBinaryStateWriter Body;
+	Body.writeOptional(State.CentralWidget.isEmpty() ? -1 : Body.intern(State.CentralWidget));
+	Body.writeVarint(quint32(State.Containers.count()));
+	for (const auto& Container : State.Containers)
+	{
+		Body.writeContainer(Container);
+	}
+
+	CBinaryStateWriter s;
+	s.Data.reserve(Body.Data.size() + Body.Strings.count() * 16 + 16);
+	s.Data.append(BinaryMagic, BinaryMagicSize);
+	s.writeByte(BinaryFormatVersion);
+	s.writeVarint(quint32(State.FileVersion));
+	s.writeSigned(State.UserVersion);
+	s.writeVarint(quint32(Body.Strings.count()));
+	for (const auto& String : Body.Strings)
+	{
+		s.writeBytes(String.toUtf8());
+	}
+	s.Data.append(Body.Data);
+	return s.Data;
+}
+
+
+//============================================================================
+bool CDockingStateBinary::read(const QByteArray& Data, DockingState& State)
+{
+	if (!isBinary(Data))
+	{
+		return false;
+	}
+
+	CBinaryStateReader s(Data);
+	s.Pos += BinaryMagicSize;
+	if (s.readByte() != BinaryFormatVersion)
+	{
+		return false;
+	}
+	State.FileVersion = int(s.readVarint());
+	State.UserVersion = s.readSigned();
+	int Count = s.readCount();
+	s.Strings.reserve(Count);
+	for (int i = 0; i < Count; ++i)
+	{
+		s.Strings.append(QString::fromUtf8(s.readBytes()));
+	}
+
+	int CentralWidget = s.readOptional();
+	if (CentralWidget >= 0)
+	{
+		State.CentralWidget = s.readString(CentralWidget);
+	}
+	Count = s.readCount();
+	State.Containers.resize(Count);
+	for (int i = 0; i < Count && !s.hasError(); ++i)
+	{
+		s.readContainer(State.Containers[i]);
+	}
+
+	return !s.hasError() && s.Pos == s.End;
+}
+
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockingStateBinary.cpp
@@ -0,0 +1,51 @@
+#ifndef DockingStateBinaryH
+#define DockingStateBinaryH
+//============================================================================
+/// \file   DockingStateBinary.h
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Declaration of CDockingStateBinary
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QByteArray>
+
+#include "DockingStateReader.h"
+
+namespace ads
+{
+/**
+ * Compact binary encoding of the docking state tree.
+ * The binary format starts with a magic header and a format version. All
+ * dock widget names are interned into a string table at the beginning of
+ * the data, all integers are stored as variable length integers and every
+ * node is stored with a fixed field layout in the same post-order as in
+ * DockContainerState::Nodes. Decoding fills the same DockingState tree as
+ * the XML reader, so the restore code is shared by both formats.
+ */
+class CDockingStateBinary
+{
+public:
+	/**
+	 * Returns true, if the given data starts with the binary format header
+	 */
+	static bool isBinary(const QByteArray& Data);
+
+	/**
+	 * Encodes the given state tree into the binary format
+	 */
+	static QByteArray write(const DockingState& State);
+
+	/**
+	 * Decodes the given binary data into the given state tree.
+	 * Returns false, if the data is truncated or invalid.
+	 */
+	static bool read(const QByteArray& Data, DockingState& State);
+};
+
+} // namespace ads
+
+//---------------------------------------------------------------------------
+#endif // DockingStateBinaryH
@@ -0,0 +1,317 @@
+//============================================================================
+/// \file   DockingStateDelta.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Implementation of CDockingStateDelta
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockingStateDelta.h"
+
+#include <QHash>
+
+#include <cstring>
+#include <limits>
+
+namespace ads
+{
+static const char DeltaMagic[] = {'A', 'D', 'S', 'D'};
+static const int DeltaMagicSize = sizeof(DeltaMagic);
+static const quint8 DeltaFormatVersion = 1;
+
+/**
+ * Size of the base blocks that are indexed for finding matches. A match
+ * is extended in both directions, so changed bytes between two matching
+ * blocks are encoded as short inserts.
+ */
+static const int DeltaBlockSize = 8;
+
+
+//============================================================================
+static void writeVarint(QByteArray& Data, quint32 Value)
+{
+	while (Value >= 0x80)
+	{
+		Data.append(char((Value & 0x7f) | 0x80));
+		Value >>= 7;
+	}
+	Data.append(char(Value));
+}
+
+
+//============================================================================
+static quint64 blockKey(const char* Data)
+{
+	quint64 Key;
+	std::memcpy(&Key, Data, sizeof(Key));
+	return Key;
+}
+
+
+//============================================================================
+static quint16 checksum(const QByteArray& Data)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+	return qChecksum(QByteArrayView(Data));
+#else
+	return qChecksum(Data.constData(), uint(Data.size()));
+#endif
+}
+
+
+/**
+ * Bounds checked reader for the delta header and operations
+ */
+struct DeltaReader
+{
+	const char* Pos;
+	const char* End;
+	bool Error = false;
+
+	DeltaReader(const QByteArray& Data)
+		: Pos(Data.constData()), End(Data.constData() + Data.size())
+	{}
+
+	quint8 readByte()
+	{
+		if (Error || Pos >= End)
+		{
+			Error = true;
+			return 0;
+		}
+		return quint8(*Pos++);
+	}
+
+	quint32 readVarint()
+	{
+		quint32 Value = 0;
+		for (int Shift = 0; Shift < 35; Shift += 7)
+		{
+			quint8 Byte = readByte();
+			Value |= quint32(Byte & 0x7f) << Shift;
+			if (!(Byte & 0x80))
+			{
+				return Value;
+			}
+		}
+		Error = true;
+		return 0;
+	}
+
+	const char* readRaw(quint32 Size)
+	{
+		if (Error || Size > quint32(End - Pos))
+		{
+			Error = true;
+			return nullptr;
+		}
+		auto Data = Pos;
+		Pos += Size;
+		return Data;
+	}
+
+	/**
+	 * Reads the header and returns the base name
+	 */
+	QString readHeader(quint32& BaseSize, quint16& BaseChecksum, quint32& StateSize)
+	{
+		auto Magic = readRaw(DeltaMagicSize);
+		if (!Magic || std::memcmp(Magic, DeltaMagic, DeltaMagicSize) != 0
+		 || readByte() != DeltaFormatVersion)
+		{
+			Error = true;
+			return QString();
+		}
+
+		quint32 NameSize = readVarint();
+		auto Name = readRaw(NameSize);
+		BaseSize = readVarint();
+		BaseChecksum = readByte();
+		BaseChecksum |= quint16(readByte() << 8);
+		StateSize = readVarint();
+		return Error ? QString() : QString::fromUtf8(Name, int(NameSize));
+	}
+};
+
+
+//============================================================================
+bool CDockingStateDelta::isDelta(const QByteArray& Data)
+{
+	return Data.size() > DeltaMagicSize
+		&& std::memcmp(Data.constData(), DeltaMagic, DeltaMagicSize) == 0;
+}
+
+
+//============================================================================
+QString CDockingStateDelta::baseName(const QByteArray& Data)
+{
+	if (!isDelta(Data))
+	{
+		return QString();
+	}
+
+	quint32 BaseSize, StateSize;
+	quint16 BaseChecksum;
+	DeltaReader Reader(Data);
+	return Reader.readHeader(BaseSize, BaseChecksum, StateSize);
+}
+
+
+//============================================================================
+QByteArray CDockingStateDelta::encode(const QString& BaseName, const QByteArray& Base,
+	const QByteArray& State)
+{
+	QByteArray Delta(DeltaMagic, DeltaMagicSize);
+	Delta.append(char(DeltaFormatVersion));
+	auto Name = BaseName.toUtf8();
+	writeVarint(Delta, quint32(Name.size()));
+	Delta.append(Name);
+	writeVarint(Delta, quint32(Base.size()));
+	auto BaseChecksum = checksum(Base);
+	Delta.append(char(BaseChecksum & 0xff));
+	Delta.append(char(BaseChecksum >> 8));
+	writeVarint(Delta, quint32(State.size()));
+
+	auto writeInsert = [&Delta](const char* Data, int Size)
+	{
+		if (Size > 0)
+		{
+			writeVarint(Delta, quint32(Size) << 1);
+			Delta.append(Data, Size);
+		}
+	};
+
+	const char* BaseData = Base.constData();
+	const int BaseSize = Base.size();
+	const char* StateData = State.constData();
+	const int StateSize = State.size();
+
+	// Index the first occurrence of every aligned block of the base
+	QHash<quint64, int> BlockIndex;
+	BlockIndex.reserve(BaseSize / DeltaBlockSize);
+	for (int Offset = 0; Offset + DeltaBlockSize <= BaseSize; Offset += DeltaBlockSize)
+	{
+		auto Key = blockKey(BaseData + Offset);
+		if (!BlockIndex.contains(Key))
+		{
+			BlockIndex.insert(Key, Offset);
+		}
+	}
+
+	int LiteralStart = 0;
+	int i = 0;
+	while (i + DeltaBlockSize <= StateSize)
+	{
+		auto it = BlockIndex.constFind(blockKey(StateData + i));
+		if (it == BlockIndex.constEnd())
+		{
+			++i;
+			continue;
+		}
+
+		// Extend the match into the pending literal and behind the block
+		int BaseOffset = it.value();
+		int Start = i;
+		while (Start > LiteralStart && BaseOffset > 0
+			&& StateData[Start - 1] == BaseData[BaseOffset - 1])
+		{
+			--Start;
+			--BaseOffset;
+		}
+		int End = i + DeltaBlockSize;
+		int BaseEnd = it.value() + DeltaBlockSize;
+		while (End < StateSize && BaseEnd < BaseSize
+			&& StateData[End] == BaseData[BaseEnd])
+		{
+			++End;
+			++BaseEnd;
+		}
+
+		writeInsert(StateData + LiteralStart, Start - LiteralStart);
+		writeVarint(Delta, (quint32(End - Start) << 1) | 1);
+		writeVarint(Delta, quint32(BaseOffset));
+		LiteralStart = i = End;
+	}
+	writeInsert(StateData + LiteralStart, StateSize - LiteralStart);
+
+	return Delta;
+}
+
+
+//============================================================================
+QByteArray CDockingStateDelta::decode(const QByteArray& Base, const QByteArray& Delta)
+{
+	if (!isDelta(Delta))
+	{
+		return QByteArray();
+	}
+
+	quint32 BaseSize, StateSize;
+	quint16 BaseChecksum;
+	DeltaReader Reader(Delta);
+	Reader.readHeader(BaseSize, BaseChecksum, StateSize);
+	if (Reader.Error || BaseSize != quint32(Base.size())
+	 || BaseChecksum != checksum(Base))
+	{
+		return QByteArray();
+	}
+
+	// Validate all operations and sum up their sizes before anything is
+	// allocated, so a corrupt or hostile header cannot force a huge
+	// allocation
+	DeltaReader Validator = Reader;
+	quint64 TotalSize = 0;
+	while (!Validator.Error && Validator.Pos < Validator.End)
+	{
+		quint32 Op = Validator.readVarint();
+		quint32 Size = Op >> 1;
+		if (Op & 1)
+		{
+			quint32 Offset = Validator.readVarint();
+			if (Offset > BaseSize || Size > BaseSize - Offset)
+			{
+				return QByteArray();
+			}
+		}
+		else if (!Validator.readRaw(Size))
+		{
+			return QByteArray();
+		}
+
+		TotalSize += Size;
+		if (TotalSize > StateSize)
+		{
+			return QByteArray();
+		}
+	}
+
+	if (Validator.Error || TotalSize != StateSize
+	 || StateSize > quint32(std::numeric_limits<int>::max()))
+	{
+		return QByteArray();
+	}
+
+	QByteArray State;
+	State.reserve(int(StateSize));
+	while (Reader.Pos < Reader.End)
+	{
+		quint32 Op = Reader.readVarint();
+		quint32 Size = Op >> 1;
+		if (Op & 1)
+		{
+			quint32 Offset = Reader.readVarint();
+			State.append(Base.constData() + Offset, int(Size));
+		}
+		else
+		{
+			State.append(Reader.readRaw(Size), int(Size));
+		}
+	}
+	return State;
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockingStateDelta.cpp
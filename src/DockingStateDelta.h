@@ -0,0 +1,59 @@
+#ifndef DockingStateDeltaH
+#define DockingStateDeltaH
+//============================================================================
+/// \file   DockingStateDelta.h
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Declaration of CDockingStateDelta
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QByteArray>
+#include <QString>
+
+namespace ads
+{
+/**
+ * Delta encoding of a saved state against a base state.
+ * The delta starts with a magic header, the name of the base perspective
+ * and the size and checksum of the base state. It is followed by a list of
+ * copy operations that reference ranges of the base state and insert
+ * operations that contain the new bytes. The binary state format stores
+ * every node with a fixed field layout, so two states that only differ in
+ * some closed flags or splitter sizes produce a delta of a few bytes.
+ */
+class CDockingStateDelta
+{
+public:
+	/**
+	 * Returns true, if the given data starts with the delta format header
+	 */
+	static bool isDelta(const QByteArray& Data);
+
+	/**
+	 * Returns the name of the base perspective of the given delta or an
+	 * empty string if Data is not a valid delta
+	 */
+	static QString baseName(const QByteArray& Data);
+
+	/**
+	 * Encodes State as delta against the given base state that is stored
+	 * as perspective with the name BaseName
+	 */
+	static QByteArray encode(const QString& BaseName, const QByteArray& Base,
+		const QByteArray& State);
+
+	/**
+	 * Applies the given delta to the given base state and returns the
+	 * decoded state. Returns an empty array, if the delta is invalid or if
+	 * it has not been encoded against the given base state.
+	 */
+	static QByteArray decode(const QByteArray& Base, const QByteArray& Delta);
+};
+
+} // namespace ads
+
+//---------------------------------------------------------------------------
+#endif // DockingStateDeltaH
@@ -10,6 +10,10 @@
 //============================================================================
 #include "DockingStateReader.h"
 
+#include <QTextStream>
+
+#include "DockManager.h"
+
 namespace ads
 {
 
@@ -24,6 +28,259 @@ int CDockingStateReader::fileVersion() const
 {
 	return m_FileVersion;
 }
+
+
+//============================================================================
+bool CDockingStateReader::readContainer(DockContainerState& Container)
+{
+	Container.Floating = attributes().value("Floating").toInt();
+	ADS_PRINT("Read container Floating " << Container.Floating);
+
+	if (Container.Floating)
+	{
+		if (!readNextStartElement() || name() != QLatin1String("Geometry"))
+		{
+			return false;
+		}
+
+		QByteArray GeometryString = readElementText(ErrorOnUnexpectedElement).toLocal8Bit();
+		Container.Geometry = QByteArray::fromHex(GeometryString);
+		if (Container.Geometry.isEmpty())
+		{
+			return false;
+		}
+	}
+
+	while (readNextStartElement())
+	{
+		bool Result = true;
+		if (name() == QLatin1String("Splitter"))
+		{
+			Result = readSplitter(Container, Container.RootNode);
+		}
+		else if (name() == QLatin1String("Area"))
+		{
+			Result = readDockArea(Container, Container.RootNode);
+		}
+		else if (name() == QLatin1String("SideBar"))
+		{
+			Result = readSideBar(Container);
+		}
+		else
+		{
+			skipCurrentElement();
+			ADS_PRINT("Unknown element");
+		}
+
+		if (!Result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//============================================================================
+bool CDockingStateReader::readSplitter(DockContainerState& Container, int& NodeIndex)
+{
+	const auto Attributes = attributes();
+	QString OrientationStr = Attributes.value("Orientation").toString();
+
+	// Check if the orientation string is right
+	if (!OrientationStr.startsWith("|") && !OrientationStr.startsWith("-"))
+	{
+		return false;
+	}
+
+	// The "|" shall indicate a vertical splitter handle which in turn means
+	// a Horizontal orientation of the splitter layout.
+	bool HorizontalSplitter = OrientationStr.startsWith("|");
+	// In version 0 we had a small bug. The "|" indicated a vertical orientation,
+	// but this is wrong, because only the splitter handle is vertical, the
+	// layout of the splitter is a horizontal layout. We fix this here
+	if (fileVersion() == 0)
+	{
+		HorizontalSplitter = !HorizontalSplitter;
+	}
+
+	bool Ok;
+	int WidgetCount = Attributes.value("Count").toInt(&Ok);
+	if (!Ok)
+	{
+		return false;
+	}
+
+	LayoutNodeState Node;
+	Node.Type = LayoutNodeState::Splitter;
+	Node.Orientation = HorizontalSplitter ? Qt::Horizontal : Qt::Vertical;
+	ADS_PRINT("Read NodeSplitter Orientation: " <<  Node.Orientation <<
+		" WidgetCount: " << WidgetCount);
+	while (readNextStartElement())
+	{
+		int ChildIndex = -1;
+		bool Result = true;
+		if (name() == QLatin1String("Splitter"))
+		{
+			Result = readSplitter(Container, ChildIndex);
+		}
+		else if (name() == QLatin1String("Area"))
+		{
+			Result = readDockArea(Container, ChildIndex);
+		}
+		else if (name() == QLatin1String("Sizes"))
+		{
+			QString sSizes = readElementText().trimmed();
+			ADS_PRINT("Sizes: " << sSizes);
+			QTextStream TextStream(&sSizes);
+			while (!TextStream.atEnd())
+			{
+				int value;
+				TextStream >> value;
+				Node.Sizes.append(value);
+			}
+		}
+		else
+		{
+			skipCurrentElement();
+		}
+
+		if (!Result)
+		{
+			return false;
+		}
+
+		if (ChildIndex >= 0)
+		{
+			Node.Children.append(ChildIndex);
+		}
+	}
+
+	if (Node.Sizes.count() != WidgetCount)
+	{
+		return false;
+	}
+
+	NodeIndex = Container.Nodes.count();
+	Container.Nodes.append(Node);
+	return true;
+}
+
+
+//============================================================================
+bool CDockingStateReader::readDockArea(DockContainerState& Container, int& NodeIndex)
+{
+	const auto Attributes = attributes();
+	LayoutNodeState Node;
+	Node.Type = LayoutNodeState::Area;
+	Node.CurrentDockWidget = Attributes.value("Current").toString();
+	ADS_PRINT("Read NodeDockArea Tabs: " << Attributes.value("Tabs")
+		<< " Current: " << Node.CurrentDockWidget);
+
+	const auto AllowedAreasAttribute = Attributes.value("AllowedAreas");
+	if (!AllowedAreasAttribute.isEmpty())
+	{
+		Node.AllowedAreas = AllowedAreasAttribute.toInt(nullptr, 16);
+	}
+
+	const auto FlagsAttribute = Attributes.value("Flags");
+	if (!FlagsAttribute.isEmpty())
+	{
+		Node.Flags = FlagsAttribute.toInt(nullptr, 16);
+	}
+
+	while (readNextStartElement())
+	{
+		if (name() != QLatin1String("Widget"))
+		{
+			skipCurrentElement();
+			continue;
+		}
+
+		DockWidgetState DockWidget;
+		if (!readDockWidget(DockWidget, false))
+		{
+			return false;
+		}
+		Node.DockWidgets.append(DockWidget);
+	}
+
+	NodeIndex = Container.Nodes.count();
+	Container.Nodes.append(Node);
+	return true;
+}
+
+
+//============================================================================
+bool CDockingStateReader::readSideBar(DockContainerState& Container)
+{
+	// Simply ignore side bar auto hide widgets from saved state if
+	// auto hide support is disabled
+	if (!CDockManager::testAutoHideConfigFlag(CDockManager::AutoHideFeatureEnabled))
+	{
+		skipCurrentElement();
+		return true;
+	}
+
+	bool Ok;
+	SideBarState SideBar;
+	SideBar.Area = (ads::SideBarLocation)attributes().value("Area").toInt(&Ok);
+	if (!Ok)
+	{
+		return false;
+	}
+
+	while (readNextStartElement())
+	{
+		if (name() != QLatin1String("Widget"))
+		{
+			skipCurrentElement();
+			continue;
+		}
+
+		DockWidgetState DockWidget;
+		if (!readDockWidget(DockWidget, true))
+		{
+			return false;
+		}
+		SideBar.DockWidgets.append(DockWidget);
+	}
+
+	Container.SideBars.append(SideBar);
+	return true;
+}
+
+
+//============================================================================
+bool CDockingStateReader::readDockWidget(DockWidgetState& DockWidget, bool ReadSize)
+{
+	const auto Attributes = attributes();
+	DockWidget.Name = Attributes.value("Name").toString();
+	if (DockWidget.Name.isEmpty())
+	{
+		return false;
+	}
+
+	bool Ok;
+	DockWidget.Closed = Attributes.value("Closed").toInt(&Ok);
+	if (!Ok)
+	{
+		return false;
+	}
+
+	if (ReadSize)
+	{
+		DockWidget.Size = Attributes.value("Size").toInt(&Ok);
+		if (!Ok)
+		{
+			return false;
+		}
+	}
+
+	skipCurrentElement();
+	return true;
+}
 } // namespace ads
 
 //---------------------------------------------------------------------------
@@ -11,9 +11,85 @@
 //                                   INCLUDES
 //============================================================================
 #include <QXmlStreamReader>
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QVector>
+
+#include "ads_globals.h"
 
 namespace ads
 {
+/**
+ * Dock widget entry of a dock area or of an auto hide side bar
+ */
+struct DockWidgetState
+{
+	QString Name;
+	int Handle = 0; ///< session local dock widget handle, 0 if not known
+	bool Closed = false;
+	int Size = 0; ///< size of the auto hide container (side bar entries only)
+};
+
+/**
+ * Splitter or dock area node of the layout tree of a dock container.
+ * Child nodes are stored as indices into DockContainerState::Nodes. Nodes
+ * are appended in post-order, that means children always come before their
+ * parent splitter.
+ */
+struct LayoutNodeState
+{
+	enum eType
+	{
+		Splitter,
+		Area
+	};
+
+	eType Type = Area;
+	Qt::Orientation Orientation = Qt::Horizontal; ///< splitter only
+	QList<int> Sizes; ///< splitter only
+	QVector<int> Children; ///< splitter only
+	QString CurrentDockWidget; ///< area only
+	int AllowedAreas = -1; ///< area only, -1 if not stored
+	int Flags = -1; ///< area only, -1 if not stored
+	QVector<DockWidgetState> DockWidgets; ///< area only
+};
+
+/**
+ * Auto hide side bar of a dock container
+ */
+struct SideBarState
+{
+	SideBarLocation Area = SideBarNone;
+	QVector<DockWidgetState> DockWidgets;
+};
+
+/**
+ * Parsed state of a single dock container
+ */
+struct DockContainerState
+{
+	bool Floating = false;
+	QByteArray Geometry;
+	QVector<LayoutNodeState> Nodes;
+	int RootNode = -1; ///< index of the root node or -1 for an empty container
+	QVector<SideBarState> SideBars;
+	QByteArray XmlFragment; ///< cached XML encoding of this container or empty
+	bool XmlFragmentAutoFormatting = false; ///< auto formatting of XmlFragment
+};
+
+/**
+ * Validated intermediate tree of a complete docking state. The state data
+ * is parsed once into this tree and the widgets are created from the tree
+ * afterwards, so restoring never needs a second parsing pass.
+ */
+struct DockingState
+{
+	int FileVersion = 0;
+	int UserVersion = 0;
+	QString CentralWidget;
+	QVector<DockContainerState> Containers;
+};
 
 /**
  * Extends QXmlStreamReader with file version information
@@ -21,7 +97,12 @@ namespace ads
 class CDockingStateReader : public QXmlStreamReader
 {
 private:
-	int m_FileVersion;
+	int m_FileVersion = 0;
+
+	bool readSplitter(DockContainerState& Container, int& NodeIndex);
+	bool readDockArea(DockContainerState& Container, int& NodeIndex);
+	bool readSideBar(DockContainerState& Container);
+	bool readDockWidget(DockWidgetState& DockWidget, bool ReadSize);
 
 public:
 	using QXmlStreamReader::QXmlStreamReader;
@@ -35,6 +116,13 @@ public:
 	 * Returns the file version set via setFileVersion
 	 */
 	int fileVersion() const;
+
+	/**
+	 * Parses the current "Container" element including all its child
+	 * nodes into the given container state.
+	 * Returns false, if the container data is invalid.
+	 */
+	bool readContainer(DockContainerState& Container);
 };
 
 } // namespace ads
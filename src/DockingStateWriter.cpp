@@ -0,0 +1,310 @@
+//============================================================================
+/// \file   DockingStateWriter.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Implementation of CDockingStateWriter
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DockingStateWriter.h"
+
+#include <QXmlStreamWriter>
+#include <QBuffer>
+
+#include <algorithm>
+
+#if QT_VERSION < 0x050900
+// Implemented in DockContainerWidget.cpp
+QByteArray qByteArrayToHex(const QByteArray& src, char separator);
+#endif
+
+namespace ads
+{
+/**
+ * Writes the nodes of a single container
+ */
+class CXmlStateWriter
+{
+public:
+	QXmlStreamWriter& s;
+
+	CXmlStateWriter(QXmlStreamWriter& Stream) : s(Stream) {}
+
+	void writeDockWidget(const DockWidgetState& DockWidget, bool WriteSize)
+	{
+		s.writeStartElement("Widget");
+		s.writeAttribute("Name", DockWidget.Name);
+		s.writeAttribute("Closed", QString::number(DockWidget.Closed ? 1 : 0));
+		if (WriteSize)
+		{
+			s.writeAttribute("Size", QString::number(DockWidget.Size));
+		}
+		s.writeEndElement();
+	}
+
+	void writeNode(const DockContainerState& Container, int NodeIndex)
+	{
+		const auto& Node = Container.Nodes[NodeIndex];
+		if (LayoutNodeState::Splitter == Node.Type)
+		{
+			s.writeStartElement("Splitter");
+			s.writeAttribute("Orientation", (Node.Orientation == Qt::Horizontal) ? "|" : "-");
+			s.writeAttribute("Count", QString::number(Node.Sizes.count()));
+			for (auto Child : Node.Children)
+			{
+				writeNode(Container, Child);
+			}
+
+			s.writeStartElement("Sizes");
+			for (auto Size : Node.Sizes)
+			{
+				s.writeCharacters(QString::number(Size) + " ");
+			}
+			s.writeEndElement();
+			s.writeEndElement();
+		}
+		else
+		{
+			writeDockArea(Node);
+		}
+	}
+
+	void writeDockArea(const LayoutNodeState& Node)
+	{
+		s.writeStartElement("Area");
+		s.writeAttribute("Tabs", QString::number(Node.DockWidgets.count()));
+		s.writeAttribute("Current", Node.CurrentDockWidget);
+		if (Node.AllowedAreas >= 0)
+		{
+			s.writeAttribute("AllowedAreas", QString::number(Node.AllowedAreas, 16));
+		}
+		if (Node.Flags >= 0)
+		{
+			s.writeAttribute("Flags", QString::number(Node.Flags, 16));
+		}
+		for (const auto& DockWidget : Node.DockWidgets)
+		{
+			writeDockWidget(DockWidget, false);
+		}
+		s.writeEndElement();
+	}
+
+	void writeSideBar(const SideBarState& SideBar)
+	{
+		s.writeStartElement("SideBar");
+		s.writeAttribute("Area", QString::number(SideBar.Area));
+		s.writeAttribute("Tabs", QString::number(SideBar.DockWidgets.count()));
+		for (const auto& DockWidget : SideBar.DockWidgets)
+		{
+			writeDockWidget(DockWidget, true);
+		}
+		s.writeEndElement();
+	}
+
+	void writeContainer(const DockContainerState& Container)
+	{
+		s.writeStartElement("Container");
+		s.writeAttribute("Floating", QString::number(Container.Floating ? 1 : 0));
+		if (Container.Floating)
+		{
+#if QT_VERSION < 0x050900
+			s.writeTextElement("Geometry", qByteArrayToHex(Container.Geometry, ' '));
+#else
+			s.writeTextElement("Geometry", QString::fromLatin1(Container.Geometry.toHex(' ')));
+#endif
+		}
+
+		if (Container.RootNode >= 0)
+		{
+			writeNode(Container, Container.RootNode);
+		}
+
+		for (const auto& SideBar : Container.SideBars)
+		{
+			writeSideBar(SideBar);
+		}
+		s.writeEndElement();
+	}
+};
+
+
+//============================================================================
+static bool hasXmlFragment(const DockContainerState& Container, bool AutoFormatting)
+{
+	return !Container.XmlFragment.isEmpty()
+		&& Container.XmlFragmentAutoFormatting == AutoFormatting;
+}
+
+
+//============================================================================
+static void writeDocument(QXmlStreamWriter& s, const DockingState& State,
+	bool WriteContainers)
+{
+	s.writeStartDocument();
+	s.writeStartElement("QtAdvancedDockingSystem");
+	s.writeAttribute("Version", QString::number(State.FileVersion));
+	s.writeAttribute("UserVersion", QString::number(State.UserVersion));
+	s.writeAttribute("Containers", QString::number(State.Containers.count()));
+	if (!State.CentralWidget.isEmpty())
+	{
+		s.writeAttribute("CentralWidget", State.CentralWidget);
+	}
+
+	if (WriteContainers)
+	{
+		CXmlStateWriter Writer(s);
+		for (const auto& Container : State.Containers)
+		{
+			Writer.writeContainer(Container);
+		}
+	}
+	else
+	{
+		s.writeEmptyElement("Container");
+	}
+
+	s.writeEndElement();
+	s.writeEndDocument();
+}
+
+
+//============================================================================
+QByteArray CDockingStateWriter::writeXml(const DockingState& State, bool AutoFormatting)
+{
+	QByteArray Data;
+	QBuffer Buffer(&Data);
+	Buffer.open(QIODevice::WriteOnly);
+	writeXml(State, &Buffer, AutoFormatting);
+	return Data;
+}
+
+
+//============================================================================
+bool CDockingStateWriter::writeXml(const DockingState& State, QIODevice* Device,
+	bool AutoFormatting)
+{
+	// Write the document frame with an empty Container element as
+	// placeholder and splice the container fragments into the frame. The
+	// fragments include the indentation, so the result is identical to the
+	// document that is written in one pass.
+	static const QByteArray Placeholder("<Container/>");
+	QByteArray Frame;
+	int Pos = -1;
+	bool UseFragments = std::any_of(State.Containers.begin(), State.Containers.end(),
+		[AutoFormatting](const DockContainerState& Container)
+		{
+			return hasXmlFragment(Container, AutoFormatting);
+		});
+	if (UseFragments)
+	{
+		QXmlStreamWriter s(&Frame);
+		s.setAutoFormatting(AutoFormatting);
+		writeDocument(s, State, false);
+		Pos = Frame.indexOf(Placeholder);
+	}
+
+	if (Pos < 0)
+	{
+		QXmlStreamWriter s(Device);
+		s.setAutoFormatting(AutoFormatting);
+		writeDocument(s, State, true);
+		return !s.hasError();
+	}
+
+	int HeadSize = Pos;
+	while (HeadSize > 0 && (Frame.at(HeadSize - 1) == ' ' || Frame.at(HeadSize - 1) == '\n'))
+	{
+		--HeadSize;
+	}
+
+	bool Result = (Device->write(Frame.constData(), HeadSize) == HeadSize);
+	for (const auto& Container : State.Containers)
+	{
+		auto Fragment = hasXmlFragment(Container, AutoFormatting) ? Container.XmlFragment
+			: writeContainerFragment(Container, AutoFormatting);
+		Result = Result && (Device->write(Fragment) == Fragment.size());
+	}
+	auto Tail = Frame.mid(Pos + Placeholder.size());
+	return Result && (Device->write(Tail) == Tail.size());
+}
+
+
+//============================================================================
+QByteArray CDockingStateWriter::writeContainerFragment(const DockContainerState& Container,
+	bool AutoFormatting)
+{
+	// The container is written into a root element to get the same
+	// indentation like in a complete document. The root tags and the
+	// whitespace in front of the root end tag are removed afterwards.
+	QByteArray Data;
+	{
+		QXmlStreamWriter s(&Data);
+		s.setAutoFormatting(AutoFormatting);
+		s.writeStartElement("QtAdvancedDockingSystem");
+		CXmlStateWriter Writer(s);
+		Writer.writeContainer(Container);
+		s.writeEndElement();
+	}
+
+	static const QByteArray StartTag("<QtAdvancedDockingSystem>");
+	static const QByteArray EndTag("</QtAdvancedDockingSystem>");
+	Data.truncate(Data.lastIndexOf(EndTag));
+	while (Data.endsWith(' ') || Data.endsWith('\n'))
+	{
+		Data.chop(1);
+	}
+	Data.remove(0, Data.indexOf(StartTag) + StartTag.size());
+	return Data;
+}
+
+
+//============================================================================
+bool CDockingStateWriter::writeContainerXml(const DockContainerState& Container,
+	QIODevice* Device, bool AutoFormatting)
+{
+	QXmlStreamWriter s(Device);
+	s.setAutoFormatting(AutoFormatting);
+	s.writeStartDocument();
+	CXmlStateWriter Writer(s);
+	Writer.writeContainer(Container);
+	s.writeEndDocument();
+	return !s.hasError();
+}
+
+
+//============================================================================
+void CDockingStateWriter::writeContainer(QXmlStreamWriter& Stream,
+	const DockContainerState& Container)
+{
+	CXmlStateWriter(Stream).writeContainer(Container);
+}
+
+
+//============================================================================
+void CDockingStateWriter::writeDockArea(QXmlStreamWriter& Stream,
+	const LayoutNodeState& Node)
+{
+	CXmlStateWriter(Stream).writeDockArea(Node);
+}
+
+
+//============================================================================
+void CDockingStateWriter::writeSideBar(QXmlStreamWriter& Stream,
+	const SideBarState& SideBar)
+{
+	CXmlStateWriter(Stream).writeSideBar(SideBar);
+}
+
+
+//============================================================================
+void CDockingStateWriter::writeDockWidget(QXmlStreamWriter& Stream,
+	const DockWidgetState& DockWidget, bool WriteSize)
+{
+	CXmlStateWriter(Stream).writeDockWidget(DockWidget, WriteSize);
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DockingStateWriter.cpp
@@ -0,0 +1,88 @@
+#ifndef DockingStateWriterH
+#define DockingStateWriterH
+//============================================================================
+/// \file   DockingStateWriter.h
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Declaration of CDockingStateWriter
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QByteArray>
+#include <QIODevice>
+
+#include "DockingStateReader.h"
+
+QT_FORWARD_DECLARE_CLASS(QXmlStreamWriter)
+
+namespace ads
+{
+/**
+ * Writes a docking state tree in the XML format.
+ * The writer only works on the state tree and does not access any widget,
+ * so it can run in a worker thread on a state that has been captured in
+ * the GUI thread. The element writers are used by the saveState() functions
+ * of the widgets that write into a QXmlStreamWriter.
+ */
+class CDockingStateWriter
+{
+public:
+	/**
+	 * Encodes the given state tree into the XML format that is read by
+	 * CDockingStateReader
+	 */
+	static QByteArray writeXml(const DockingState& State, bool AutoFormatting);
+
+	/**
+	 * Streams the XML encoding of the given state tree into the given
+	 * device. Returns false, if writing to the device failed.
+	 */
+	static bool writeXml(const DockingState& State, QIODevice* Device,
+		bool AutoFormatting);
+
+	/**
+	 * Streams a single Container element as standalone XML document into
+	 * the given device. Returns false, if writing to the device failed.
+	 */
+	static bool writeContainerXml(const DockContainerState& Container,
+		QIODevice* Device, bool AutoFormatting);
+
+	/**
+	 * Encodes the Container element of the given container state as it is
+	 * written into a complete document. writeXml() splices a matching
+	 * DockContainerState::XmlFragment into the document instead of encoding
+	 * the container again.
+	 */
+	static QByteArray writeContainerFragment(const DockContainerState& Container,
+		bool AutoFormatting);
+
+	/**
+	 * Writes the Container element of the given container state
+	 */
+	static void writeContainer(QXmlStreamWriter& Stream,
+		const DockContainerState& Container);
+
+	/**
+	 * Writes the Area element of the given dock area node
+	 */
+	static void writeDockArea(QXmlStreamWriter& Stream, const LayoutNodeState& Node);
+
+	/**
+	 * Writes the SideBar element of the given side bar state
+	 */
+	static void writeSideBar(QXmlStreamWriter& Stream, const SideBarState& SideBar);
+
+	/**
+	 * Writes the Widget element of the given dock widget state. The Size
+	 * attribute is only written for auto hide widgets.
+	 */
+	static void writeDockWidget(QXmlStreamWriter& Stream,
+		const DockWidgetState& DockWidget, bool WriteSize);
+};
+
+} // namespace ads
+
+//---------------------------------------------------------------------------
+#endif // DockingStateWriterH
@@ -0,0 +1,321 @@
+//============================================================================
+/// \file   DragPreviewCache.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Implementation of CDragPreviewCache class
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "DragPreviewCache.h"
+
+#include <QApplication>
+#include <QEvent>
+#include <QHash>
+#include <QPainter>
+#include <QPointer>
+#include <QTimer>
+#include <QWidget>
+
+#include "DockManager.h"
+#include "DockHitTestIndex.h"
+
+namespace ads
+{
+/**
+ * Delay between the rendering of two outdated snapshots to keep the
+ * application responsive
+ */
+static const int NextRefreshDelay = 50;
+
+/**
+ * Cached snapshot of a single widget
+ */
+struct SnapshotEntry
+{
+	QPointer<QWidget> Widget;
+	QPixmap Pixmap;
+	quint64 Generation = 1;
+	quint64 SnapshotGeneration = 0;
+
+	bool isValid() const {return !Pixmap.isNull() && Generation == SnapshotGeneration;}
+};
+
+/**
+ * Private data class of CDragPreviewCache class (pimpl)
+ */
+struct DragPreviewCachePrivate
+{
+	CDragPreviewCache *_this;
+	CDockManager* DockManager;
+	QHash<const QObject*, SnapshotEntry> Entries;
+	QTimer RefreshTimer;
+	QSize MaxSnapshotSize = QSize(512, 512);
+	int RefreshDelay = 1000;
+
+	/**
+	 * Private data constructor
+	 */
+	DragPreviewCachePrivate(CDragPreviewCache *_public);
+
+	/**
+	 * Restarts the refresh timer so that outdated snapshots are rendered if
+	 * no content changed for the refresh delay
+	 */
+	void scheduleRefresh()
+	{
+		RefreshTimer.start(RefreshDelay);
+	}
+
+	/**
+	 * Returns the first outdated entry of a visible widget or a nullptr
+	 */
+	SnapshotEntry* nextOutdatedEntry();
+
+	/**
+	 * Renders the given widget into a pixmap with a capped resolution
+	 */
+	QPixmap renderSnapshot(QWidget* Widget) const;
+}; // struct DragPreviewCachePrivate
+
+
+//============================================================================
+DragPreviewCachePrivate::DragPreviewCachePrivate(CDragPreviewCache *_public) :
+	_this(_public)
+{
+
+}
+
+
+//============================================================================
+SnapshotEntry* DragPreviewCachePrivate::nextOutdatedEntry()
+{
+	for (auto& Entry : Entries)
+	{
+		if (!Entry.isValid() && Entry.Widget && Entry.Widget->isVisible())
+		{
+			return &Entry;
+		}
+	}
+	return nullptr;
+}
+
+
+//============================================================================
+QPixmap DragPreviewCachePrivate::renderSnapshot(QWidget* Widget) const
+{
+	QSize Size = Widget->size();
+	if (Size.isEmpty())
+	{
+		return QPixmap();
+	}
+
+	QSize SnapshotSize = Size;
+	if (Size.width() > MaxSnapshotSize.width() || Size.height() > MaxSnapshotSize.height())
+	{
+		SnapshotSize = Size.scaled(MaxSnapshotSize, Qt::KeepAspectRatio).expandedTo(QSize(1, 1));
+	}
+
+	qreal DevicePixelRatio = Widget->devicePixelRatioF();
+	QPixmap Pixmap(SnapshotSize * DevicePixelRatio);
+	Pixmap.setDevicePixelRatio(DevicePixelRatio);
+	Pixmap.fill(Widget->palette().color(QPalette::Window));
+	QPainter Painter(&Pixmap);
+	Painter.scale(qreal(SnapshotSize.width()) / Size.width(),
+		qreal(SnapshotSize.height()) / Size.height());
+	Widget->render(&Painter, QPoint(), QRegion(),
+		QWidget::DrawWindowBackground | QWidget::DrawChildren);
+	return Pixmap;
+}
+
+
+//============================================================================
+CDragPreviewCache::CDragPreviewCache(CDockManager* DockManager) :
+	Super(DockManager),
+	d(new DragPreviewCachePrivate(this))
+{
+	d->DockManager = DockManager;
+	d->RefreshTimer.setSingleShot(true);
+	connect(&d->RefreshTimer, SIGNAL(timeout()), SLOT(onRefreshTimeout()));
+}
+
+
+//============================================================================
+CDragPreviewCache::~CDragPreviewCache()
+{
+	delete d;
+}
+
+
+//============================================================================
+void CDragPreviewCache::setMaxSnapshotSize(const QSize& Size)
+{
+	if (Size == d->MaxSnapshotSize)
+	{
+		return;
+	}
+
+	d->MaxSnapshotSize = Size;
+	for (auto& Entry : d->Entries)
+	{
+		Entry.Generation++;
+	}
+	d->scheduleRefresh();
+}
+
+
+//============================================================================
+QSize CDragPreviewCache::maxSnapshotSize() const
+{
+	return d->MaxSnapshotSize;
+}
+
+
+//============================================================================
+void CDragPreviewCache::setRefreshDelay(int Milliseconds)
+{
+	d->RefreshDelay = qMax(0, Milliseconds);
+}
+
+
+//============================================================================
+int CDragPreviewCache::refreshDelay() const
+{
+	return d->RefreshDelay;
+}
+
+
+//============================================================================
+void CDragPreviewCache::watch(QWidget* Content)
+{
+	if (!Content || d->Entries.contains(Content))
+	{
+		return;
+	}
+
+	SnapshotEntry Entry;
+	Entry.Widget = Content;
+	d->Entries.insert(Content, Entry);
+	Content->installEventFilter(this);
+	connect(Content, &QObject::destroyed, this, [this](QObject* Object)
+	{
+		d->Entries.remove(Object);
+	});
+	d->scheduleRefresh();
+}
+
+
+//============================================================================
+void CDragPreviewCache::forget(QWidget* Content)
+{
+	if (!Content || !d->Entries.remove(Content))
+	{
+		return;
+	}
+
+	Content->removeEventFilter(this);
+	disconnect(Content, &QObject::destroyed, this, nullptr);
+}
+
+
+//============================================================================
+void CDragPreviewCache::invalidate(QWidget* Content)
+{
+	auto it = d->Entries.find(Content);
+	if (it == d->Entries.end())
+	{
+		return;
+	}
+
+	it->Generation++;
+	d->scheduleRefresh();
+}
+
+
+//============================================================================
+QPixmap CDragPreviewCache::snapshot(QWidget* Content)
+{
+	auto it = d->Entries.find(Content);
+	if (it == d->Entries.end())
+	{
+		watch(Content);
+		return QPixmap();
+	}
+
+	if (!it->isValid())
+	{
+		d->scheduleRefresh();
+	}
+	return it->Pixmap;
+}
+
+
+//============================================================================
+bool CDragPreviewCache::isSnapshotValid(QWidget* Content) const
+{
+	auto it = d->Entries.constFind(Content);
+	return (it != d->Entries.constEnd()) && it->isValid();
+}
+
+
+//============================================================================
+void CDragPreviewCache::clear()
+{
+	for (auto& Entry : d->Entries)
+	{
+		Entry.Pixmap = QPixmap();
+		Entry.SnapshotGeneration = 0;
+	}
+	d->scheduleRefresh();
+}
+
+
+//============================================================================
+void CDragPreviewCache::onRefreshTimeout()
+{
+	// Do not render while the user interacts with the application
+	if (QApplication::mouseButtons() != Qt::NoButton
+	 || d->DockManager->hitTestIndex()->isDragActive())
+	{
+		d->scheduleRefresh();
+		return;
+	}
+
+	auto Entry = d->nextOutdatedEntry();
+	if (!Entry)
+	{
+		return;
+	}
+
+	// Render only one snapshot per timeout to keep the event loop responsive
+	Entry->Pixmap = d->renderSnapshot(Entry->Widget);
+	Entry->SnapshotGeneration = Entry->Generation;
+	if (d->nextOutdatedEntry())
+	{
+		d->RefreshTimer.start(NextRefreshDelay);
+	}
+}
+
+
+//============================================================================
+bool CDragPreviewCache::eventFilter(QObject* watched, QEvent* event)
+{
+	switch (event->type())
+	{
+	case QEvent::Resize:
+	case QEvent::Show:
+	case QEvent::StyleChange:
+		invalidate(qobject_cast<QWidget*>(watched));
+		break;
+
+	default:
+		break;
+	}
+
+	return Super::eventFilter(watched, event);
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF DragPreviewCache.cpp
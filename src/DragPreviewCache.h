@@ -0,0 +1,125 @@
+#ifndef DragPreviewCacheH
+#define DragPreviewCacheH
+//============================================================================
+/// \file   DragPreviewCache.h
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Declaration of CDragPreviewCache class
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QObject>
+#include <QPixmap>
+#include <QSize>
+
+#include "ads_globals.h"
+
+namespace ads
+{
+struct DragPreviewCachePrivate;
+class CDockManager;
+
+/**
+ * Cache for the content snapshots that are shown by the drag preview if
+ * the DragPreviewShowsContentPixmap flag is set.
+ * The snapshots are rendered with a capped resolution when the application
+ * is idle. Each cached widget has a content generation that is incremented
+ * if the widget is resized or shown or if invalidate() is called. A snapshot
+ * is refreshed if its generation is older than the content generation. So a
+ * drag can always start immediately with the last cached snapshot.
+ */
+class ADS_EXPORT CDragPreviewCache : public QObject
+{
+	Q_OBJECT
+private:
+	DragPreviewCachePrivate* d; ///< private data (pimpl)
+	friend struct DragPreviewCachePrivate;
+
+private Q_SLOTS:
+	void onRefreshTimeout();
+
+public:
+	using Super = QObject;
+
+	/**
+	 * Creates the cache for the dock widgets of the given dock manager
+	 */
+	CDragPreviewCache(CDockManager* DockManager);
+
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~CDragPreviewCache();
+
+	/**
+	 * Sets the maximum size of a snapshot in device independent pixels.
+	 * Larger contents are scaled down preserving the aspect ratio.
+	 * The default size is 512 x 512.
+	 */
+	void setMaxSnapshotSize(const QSize& Size);
+
+	/**
+	 * Returns the maximum size of a snapshot
+	 */
+	QSize maxSnapshotSize() const;
+
+	/**
+	 * Sets the time in milliseconds without content changes after that
+	 * outdated snapshots are refreshed. The default delay is 1000 ms.
+	 */
+	void setRefreshDelay(int Milliseconds);
+
+	/**
+	 * Returns the refresh delay in milliseconds
+	 */
+	int refreshDelay() const;
+
+	/**
+	 * Adds the given widget to the cache. The snapshot is rendered the next
+	 * time the application is idle.
+	 */
+	void watch(QWidget* Content);
+
+	/**
+	 * Removes the given widget and its snapshot from the cache
+	 */
+	void forget(QWidget* Content);
+
+	/**
+	 * Increments the content generation of the given widget. Call this
+	 * function if the content changed without being resized - i.e. if a
+	 * plot shows new data.
+	 */
+	void invalidate(QWidget* Content);
+
+	/**
+	 * Returns the cached snapshot for the given widget. The snapshot may be
+	 * outdated or a null pixmap if the widget has not been rendered yet.
+	 * Outdated snapshots are refreshed later. This function never renders
+	 * the widget.
+	 */
+	QPixmap snapshot(QWidget* Content);
+
+	/**
+	 * Returns true, if the snapshot of the given widget exists and matches
+	 * the content generation
+	 */
+	bool isSnapshotValid(QWidget* Content) const;
+
+	/**
+	 * Removes all snapshots
+	 */
+	void clear();
+
+	/**
+	 * Updates the content generation if a watched widget is resized or
+	 * shown
+	 */
+	virtual bool eventFilter(QObject* watched, QEvent* event) override;
+}; // class CDragPreviewCache
+} // namespace ads
+
+//---------------------------------------------------------------------------
+#endif // DragPreviewCacheH
@@ -29,10 +29,251 @@
 //============================================================================
 #include "ElidingLabel.h"
 #include <QMouseEvent>
+#include <QHash>
+#include <QFontMetrics>
 
 
 namespace ads
 {
+/**
+ * Maximum number of texts per cache. If the limit is reached, the cache is
+ * cleared
+ */
+static const int MaxCachedTexts = 4096;
+
+/**
+ * Maximum number of elided variants per text
+ */
+static const int MaxCachedWidths = 32;
+
+static int WidthBucketSize = 4;
+static quint64 CacheHits = 0;
+static quint64 CacheMisses = 0;
+
+/**
+ * Cached data of a single text
+ */
+struct ElisionEntry
+{
+	int Width = -1;
+	QHash<int, QString> ElidedTexts;
+};
+
+/**
+ * Private data of public CElisionCache
+ */
+struct ElisionCachePrivate
+{
+	QFontMetrics Metrics;
+	Qt::TextElideMode ElideMode;
+	QHash<QString, ElisionEntry> Entries;
+
+	ElisionCachePrivate(const QFont& Font, Qt::TextElideMode Mode,
+		QPaintDevice* PaintDevice)
+		: Metrics(Font, PaintDevice), ElideMode(Mode) {}
+
+	/**
+	 * Returns the cache entry for the given text with a valid text width
+	 */
+	ElisionEntry& entry(const QString& Text, bool& Hit);
+};
+
+
+/**
+ * Owner of all shared caches
+ */
+struct ElisionCacheRegistry
+{
+	QHash<QString, CElisionCache*> Caches;
+
+	~ElisionCacheRegistry()
+	{
+		qDeleteAll(Caches);
+	}
+};
+
+
+//============================================================================
+static void countLookup(bool Hit)
+{
+	if (Hit)
+	{
+		CacheHits++;
+	}
+	else
+	{
+		CacheMisses++;
+	}
+}
+
+
+//============================================================================
+static ElisionCacheRegistry& elisionCacheRegistry()
+{
+	static ElisionCacheRegistry Registry;
+	return Registry;
+}
+
+
+//============================================================================
+ElisionEntry& ElisionCachePrivate::entry(const QString& Text, bool& Hit)
+{
+	auto it = Entries.find(Text);
+	if (it != Entries.end())
+	{
+		Hit = true;
+		return it.value();
+	}
+
+	if (Entries.count() >= MaxCachedTexts)
+	{
+		Entries.clear();
+	}
+	Hit = false;
+	auto& Entry = Entries[Text];
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 11, 0))
+	Entry.Width = Metrics.horizontalAdvance(Text);
+#else
+	Entry.Width = Metrics.width(Text);
+#endif
+	return Entry;
+}
+
+
+//============================================================================
+CElisionCache::CElisionCache(const QFont& Font, Qt::TextElideMode Mode,
+	QPaintDevice* PaintDevice) :
+	d(new ElisionCachePrivate(Font, Mode, PaintDevice))
+{
+
+}
+
+
+//============================================================================
+CElisionCache::~CElisionCache()
+{
+	delete d;
+}
+
+
+//============================================================================
+CElisionCache* CElisionCache::instance(const QFont& Font, Qt::TextElideMode Mode,
+	QPaintDevice* PaintDevice)
+{
+	// The same font has different text widths on screens with a different
+	// logical DPI, so the DPI is part of the key
+	auto& Caches = elisionCacheRegistry().Caches;
+	int Dpi = PaintDevice ? PaintDevice->logicalDpiY() : 0;
+	auto Key = Font.key() + QLatin1Char('/') + QString::number(int(Mode))
+		+ QLatin1Char('/') + QString::number(Dpi);
+	auto Cache = Caches.value(Key);
+	if (!Cache)
+	{
+		Cache = new CElisionCache(Font, Mode, PaintDevice);
+		Caches.insert(Key, Cache);
+	}
+	return Cache;
+}
+
+
+//============================================================================
+QString CElisionCache::elidedText(const QString& Text, int Width)
+{
+	bool Hit;
+	auto& Entry = d->entry(Text, Hit);
+	if (Width >= Entry.Width)
+	{
+		countLookup(Hit);
+		return Text;
+	}
+
+	int Bucket = qMax(0, Width) / WidthBucketSize;
+	auto it = Entry.ElidedTexts.constFind(Bucket);
+	countLookup(it != Entry.ElidedTexts.constEnd());
+	if (it != Entry.ElidedTexts.constEnd())
+	{
+		return it.value();
+	}
+
+	if (Entry.ElidedTexts.count() >= MaxCachedWidths)
+	{
+		Entry.ElidedTexts.clear();
+	}
+	auto ElidedText = d->Metrics.elidedText(Text, d->ElideMode, Bucket * WidthBucketSize);
+	Entry.ElidedTexts.insert(Bucket, ElidedText);
+	return ElidedText;
+}
+
+
+//============================================================================
+int CElisionCache::textWidth(const QString& Text)
+{
+	bool Hit;
+	auto Width = d->entry(Text, Hit).Width;
+	countLookup(Hit);
+	return Width;
+}
+
+
+//============================================================================
+void CElisionCache::clear()
+{
+	d->Entries.clear();
+}
+
+
+//============================================================================
+void CElisionCache::clearAll()
+{
+	for (auto Cache : elisionCacheRegistry().Caches)
+	{
+		Cache->clear();
+	}
+}
+
+
+//============================================================================
+void CElisionCache::setWidthBucketSize(int Size)
+{
+	Size = qMax(1, Size);
+	if (Size == WidthBucketSize)
+	{
+		return;
+	}
+
+	WidthBucketSize = Size;
+	clearAll();
+}
+
+
+//============================================================================
+int CElisionCache::widthBucketSize()
+{
+	return WidthBucketSize;
+}
+
+
+//============================================================================
+quint64 CElisionCache::hitCount()
+{
+	return CacheHits;
+}
+
+
+//============================================================================
+quint64 CElisionCache::missCount()
+{
+	return CacheMisses;
+}
+
+
+//============================================================================
+void CElisionCache::resetCounters()
+{
+	CacheHits = 0;
+	CacheMisses = 0;
+}
+
 /**
  * Private data of public CClickableLabel
  */
@@ -42,11 +283,33 @@ struct ElidingLabelPrivate
 	Qt::TextElideMode ElideMode = Qt::ElideNone;
 	QString Text;
 	bool IsElided = false;
+	CElisionCache* Cache = nullptr;
+	int ElideWidth = -1;
 
 	ElidingLabelPrivate(CElidingLabel* _public) : _this(_public) {}
 
 	void elideText(int Width);
 
+	/**
+	 * Returns the shared elision cache for the current font and elide mode
+	 */
+	CElisionCache* cache()
+	{
+		if (!Cache)
+		{
+			Cache = CElisionCache::instance(_this->font(), ElideMode, _this);
+		}
+		return Cache;
+	}
+
+	/**
+	 * Forces a new elision the next time elideText() is called
+	 */
+	void invalidate()
+	{
+		ElideWidth = -1;
+	}
+
 	/**
 	 * Convenience function to check if the
 	 */
@@ -64,8 +327,15 @@ void ElidingLabelPrivate::elideText(int Width)
 	{
 		return;
 	}
-    QFontMetrics fm = _this->fontMetrics();
-    QString  str = fm.elidedText(Text, ElideMode, Width - _this->margin() * 2 - _this->indent());
+
+	// Nothing to do if the text and the available width did not change
+	Width = Width - _this->margin() * 2 - _this->indent();
+	if (Width == ElideWidth)
+	{
+		return;
+	}
+	ElideWidth = Width;
+    QString str = cache()->elidedText(Text, Width);
     if (str == "…")
     {
     	str = Text.at(0);
@@ -76,7 +346,10 @@ void ElidingLabelPrivate::elideText(int Width)
     {
         Q_EMIT _this->elidedChanged(IsElided);
     }
-    _this->QLabel::setText(str);
+    if (str != _this->QLabel::text())
+    {
+    	_this->QLabel::setText(str);
+    }
 }
 
 
@@ -117,6 +390,8 @@ Qt::TextElideMode CElidingLabel::elideMode() const
 void CElidingLabel::setElideMode(Qt::TextElideMode mode)
 {
 	d->ElideMode = mode;
+	d->Cache = nullptr;
+	d->invalidate();
 	d->elideText(size().width());
 }
 
@@ -160,6 +435,21 @@ void CElidingLabel::resizeEvent(QResizeEvent *event)
 }
 
 
+//============================================================================
+void CElidingLabel::changeEvent(QEvent *event)
+{
+	Super::changeEvent(event);
+	// Qt sends a font change event if the label moves to a screen with a
+	// different logical DPI, so this also selects the cache for the new DPI
+	if (event->type() == QEvent::FontChange)
+	{
+		d->Cache = nullptr;
+		d->invalidate();
+		d->elideText(size().width());
+	}
+}
+
+
 //============================================================================
 QSize CElidingLabel::minimumSizeHint() const
 {
@@ -172,13 +462,7 @@ QSize CElidingLabel::minimumSizeHint() const
     {
         return QLabel::minimumSizeHint();
     }
-    const QFontMetrics  &fm = fontMetrics();
-    #if (QT_VERSION >= QT_VERSION_CHECK(5, 11, 0))
-        QSize size(fm.horizontalAdvance(d->Text.left(2) + "…"), fm.height());
-    #else
-        QSize size(fm.width(d->Text.left(2) + "…"), fm.height());
-    #endif
-    return size;
+    return QSize(d->cache()->textWidth(d->Text.left(2) + "…"), fontMetrics().height());
 }
 
 
@@ -194,20 +478,20 @@ QSize CElidingLabel::sizeHint() const
     {
         return QLabel::sizeHint();
     }
-    const QFontMetrics& fm = fontMetrics();
-    #if (QT_VERSION >= QT_VERSION_CHECK(5, 11, 0))
-        QSize size(fm.horizontalAdvance(d->Text), QLabel::sizeHint().height());
-    #else
-        QSize size(fm.width(d->Text), QLabel::sizeHint().height());
-    #endif
-	return size;
+	return QSize(d->cache()->textWidth(d->Text), QLabel::sizeHint().height());
 }
 
 
 //============================================================================
 void CElidingLabel::setText(const QString &text)
 {
+	if (text == d->Text)
+	{
+		return;
+	}
+
 	d->Text = text;
+	d->invalidate();
 	if (d->isModeElideNone())
 	{
 		Super::setText(text);
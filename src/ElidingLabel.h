@@ -36,6 +36,89 @@
 namespace ads
 {
 struct ElidingLabelPrivate;
+struct ElisionCachePrivate;
+
+/**
+ * Cache for elided texts that is shared by all eliding labels with the
+ * same font, elide mode and logical DPI.
+ * The cache stores the full width of each text and the elided texts keyed
+ * by the available width. The available width is rounded down to a multiple
+ * of the width bucket size so that labels with slightly different widths
+ * share the cache entries.
+ */
+class ADS_EXPORT CElisionCache
+{
+private:
+	ElisionCachePrivate* d; ///< private data (pimpl)
+	friend struct ElisionCachePrivate;
+
+	CElisionCache(const QFont& Font, Qt::TextElideMode Mode,
+		QPaintDevice* PaintDevice);
+
+public:
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~CElisionCache();
+
+	/**
+	 * Returns the shared cache for the given font and elide mode.
+	 * The texts are measured with the logical DPI of the given paint device,
+	 * so labels on screens with different DPI use different caches. If
+	 * PaintDevice is a nullptr, the DPI of the primary screen is used.
+	 */
+	static CElisionCache* instance(const QFont& Font, Qt::TextElideMode Mode,
+		QPaintDevice* PaintDevice = nullptr);
+
+	/**
+	 * Returns the given text elided to the given width
+	 */
+	QString elidedText(const QString& Text, int Width);
+
+	/**
+	 * Returns the horizontal advance of the given text
+	 */
+	int textWidth(const QString& Text);
+
+	/**
+	 * Removes all cached texts
+	 */
+	void clear();
+
+	/**
+	 * Removes the cached texts of all shared caches
+	 */
+	static void clearAll();
+
+	/**
+	 * Sets the width bucket size in pixels. The default bucket size is 4.
+	 * A bucket size of 1 elides to the exact available width. Changing the
+	 * bucket size clears all caches.
+	 */
+	static void setWidthBucketSize(int Size);
+
+	/**
+	 * Returns the width bucket size
+	 */
+	static int widthBucketSize();
+
+	/**
+	 * Returns the number of lookups of all caches that have been answered
+	 * from the cache
+	 */
+	static quint64 hitCount();
+
+	/**
+	 * Returns the number of lookups of all caches that required a font
+	 * metrics computation
+	 */
+	static quint64 missCount();
+
+	/**
+	 * Resets the hit and miss counters
+	 */
+	static void resetCounters();
+};
 
 /**
  * A QLabel that supports eliding text.
@@ -54,6 +137,7 @@ protected:
 	virtual void mouseReleaseEvent(QMouseEvent* event) override;
     virtual void resizeEvent( QResizeEvent *event ) override;
     virtual void mouseDoubleClickEvent( QMouseEvent *ev ) override;
+    virtual void changeEvent(QEvent *event) override;
 
 public:
     using Super = QLabel;
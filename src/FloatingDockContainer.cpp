@@ -51,6 +51,8 @@
 #include "DockWidget.h"
 #include "DockOverlay.h"
 #include "DockSplitter.h"
+#include "DockHitTestIndex.h"
+#include "DockTrace.h"
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -446,11 +448,20 @@ struct FloatingDockContainerPrivate
 			return;
 		}
 
+		bool WasDragging = (DraggingFloatingWidget == DraggingState);
 		DraggingState = StateId;
         if (DraggingFloatingWidget == DraggingState)
         {
+            if (DockManager)
+            {
+                DockManager->hitTestIndex()->beginDrag(DockContainer);
+            }
             qApp->postEvent(_this, new QEvent((QEvent::Type)internal::FloatingWidgetDragStartEvent));
         }
+        else if (WasDragging && DockManager)
+        {
+            DockManager->hitTestIndex()->endDrag();
+        }
 	}
 
 	void setWindowTitle(const QString &Text)
@@ -707,6 +718,7 @@ void FloatingDockContainerPrivate::titleMouseReleaseEvent()
 //============================================================================
 void FloatingDockContainerPrivate::updateDropOverlays(const QPoint &GlobalPos)
 {
+	ADS_TRACE_SCOPE_CATEGORY("updateDropOverlays", "drag");
 	if (!_this->isVisible() || !DockManager)
 	{
 		return;
@@ -727,30 +739,9 @@ void FloatingDockContainerPrivate::updateDropOverlays(const QPoint &GlobalPos)
     }
 #endif
 
-	auto Containers = DockManager->dockContainers();
-	CDockContainerWidget *TopContainer = nullptr;
-	for (auto ContainerWidget : Containers)
-	{
-		if (!ContainerWidget->isVisible())
-		{
-			continue;
-		}
-
-		if (DockContainer == ContainerWidget)
-		{
-			continue;
-		}
-
-		QPoint MappedPos = ContainerWidget->mapFromGlobal(GlobalPos);
-		if (ContainerWidget->rect().contains(MappedPos))
-		{
-			if (!TopContainer || ContainerWidget->isInFrontOf(TopContainer))
-			{
-				TopContainer = ContainerWidget;
-			}
-		}
-	}
-
+	auto HitTestIndex = DockManager->hitTestIndex();
+	CDockHitTestIndex::FrameTimer FrameTimer(HitTestIndex);
+	CDockContainerWidget *TopContainer = HitTestIndex->containerAt(GlobalPos);
 	DropContainer = TopContainer;
 	auto ContainerOverlay = DockManager->containerOverlay();
 	auto DockAreaOverlay = DockManager->dockAreaOverlay();
@@ -762,7 +753,7 @@ void FloatingDockContainerPrivate::updateDropOverlays(const QPoint &GlobalPos)
 		return;
 	}
 
-	int VisibleDockAreas = TopContainer->visibleDockAreaCount();
+	int VisibleDockAreas = TopContainer->layoutStatistics().VisibleDockAreas;
 	DockWidgetAreas AllowedContainerAreas = (VisibleDockAreas > 1) ? OuterDockAreas : AllDockAreas;
 	auto DockArea = TopContainer->dockAreaAt(GlobalPos);
 	// If the dock container contains only one single DockArea, then we need
@@ -1354,6 +1345,7 @@ void CFloatingDockContainer::showEvent(QShowEvent* event)
 void CFloatingDockContainer::startFloating(const QPoint &DragStartMousePos,
     const QSize &Size, eDragState DragState, QWidget *MouseEventHandler)
 {
+	ADS_TRACE_SCOPE_CATEGORY("startFloating", "drag");
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
     if (!isMaximized())
     {
@@ -1483,13 +1475,9 @@ void CFloatingDockContainer::onDockAreaCurrentChanged(int Index)
 }
 
 //============================================================================
-bool CFloatingDockContainer::restoreState(CDockingStateReader &Stream,
-    bool Testing)
+void CFloatingDockContainer::restoreState(const DockContainerState& State)
 {
-	if (!d->DockContainer->restoreState(Stream, Testing))
-	{
-		return false;
-	}
+	d->DockContainer->restoreState(State);
 	onDockAreasAddedOrRemoved();
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
 	if(d->TitleBar)
@@ -1497,7 +1485,6 @@ bool CFloatingDockContainer::restoreState(CDockingStateReader &Stream,
 		d->TitleBar->setMaximizedIcon(windowState() == Qt::WindowMaximized);
 	}
 #endif
-	return true;
 }
 
 
@@ -1576,6 +1563,7 @@ void CFloatingDockContainer::loadStylesheet()
 void CFloatingDockContainer::finishDragging()
 {
 	ADS_PRINT("CFloatingDockContainer::finishDragging");
+	ADS_TRACE_SCOPE_CATEGORY("finishDragging", "drag");
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
 	setWindowOpacity(1);
 	activateWindow();
@@ -60,6 +60,7 @@ class CDockAreaTitleBar;
 struct DockAreaTitleBarPrivate;
 class CFloatingWidgetTitleBar;
 class CDockingStateReader;
+struct DockContainerState;
 
 /**
  * Pure virtual interface for floating widgets.
@@ -161,12 +162,10 @@ protected:
 	void moveFloating() override;
 
 	/**
-	 * Restores the state from given stream.
-	 * If Testing is true, the function only parses the data from the given
-	 * stream but does not restore anything. You can use this check for
-	 * faulty files before you start restoring the state
+	 * Restores the state from the given parsed container state.
+	 * \see CDockContainerWidget::restoreState()
 	 */
-	bool restoreState(CDockingStateReader& Stream, bool Testing);
+	void restoreState(const DockContainerState& State);
 
 	/**
 	 * Call this function to update the window title
@@ -23,6 +23,9 @@
 #include "DockContainerWidget.h"
 #include "DockOverlay.h"
 #include "AutoHideDockContainer.h"
+#include "DockHitTestIndex.h"
+#include "DragPreviewCache.h"
+#include "DockTrace.h"
 #include "ads_globals.h"
 
 namespace ads
@@ -65,6 +68,7 @@ struct FloatingDragPreviewPrivate
 	{
 		Canceled = true;
 		Q_EMIT _this->draggingCanceled();
+		DockManager->hitTestIndex()->endDrag();
 		DockManager->containerOverlay()->hideOverlay();
 		DockManager->dockAreaOverlay()->hideOverlay();
 		_this->close();
@@ -118,6 +122,7 @@ struct FloatingDragPreviewPrivate
 //============================================================================
 void FloatingDragPreviewPrivate::updateDropOverlays(const QPoint &GlobalPos)
 {
+	ADS_TRACE_SCOPE_CATEGORY("updateDropOverlays", "drag");
 	if (!_this->isVisible() || !DockManager)
 	{
 		return;
@@ -131,25 +136,9 @@ void FloatingDragPreviewPrivate::updateDropOverlays(const QPoint &GlobalPos)
 		return;
 	}
 
-	auto Containers = DockManager->dockContainers();
-	CDockContainerWidget *TopContainer = nullptr;
-	for (auto ContainerWidget : Containers)
-	{
-		if (!ContainerWidget->isVisible())
-		{
-			continue;
-		}
-
-		QPoint MappedPos = ContainerWidget->mapFromGlobal(GlobalPos);
-		if (ContainerWidget->rect().contains(MappedPos))
-		{
-			if (!TopContainer || ContainerWidget->isInFrontOf(TopContainer))
-			{
-				TopContainer = ContainerWidget;
-			}
-		}
-	}
-
+	auto HitTestIndex = DockManager->hitTestIndex();
+	CDockHitTestIndex::FrameTimer FrameTimer(HitTestIndex);
+	CDockContainerWidget *TopContainer = HitTestIndex->containerAt(GlobalPos);
 	DropContainer = TopContainer;
 	auto ContainerOverlay = DockManager->containerOverlay();
 	auto DockAreaOverlay = DockManager->dockAreaOverlay();
@@ -168,7 +157,7 @@ void FloatingDragPreviewPrivate::updateDropOverlays(const QPoint &GlobalPos)
 	auto DockDropArea = DockAreaOverlay->dropAreaUnderCursor();
 	auto ContainerDropArea = ContainerOverlay->dropAreaUnderCursor();
 
-	int VisibleDockAreas = TopContainer->visibleDockAreaCount();
+	int VisibleDockAreas = TopContainer->layoutStatistics().VisibleDockAreas;
 
 	// Include the overlay widget we're dragging as a visible widget
 	auto dockAreaWidget = qobject_cast<CDockAreaWidget*>(Content);
@@ -309,13 +298,13 @@ CFloatingDragPreview::CFloatingDragPreview(QWidget* Content, QWidget* parent) :
     setWindowFlags(Flags);
 #endif
 
-	// Create a static image of the widget that should get undocked
+	// Use the cached static image of the widget that should get undocked.
 	// This is like some kind preview image like it is uses in drag and drop
-	// operations
-	if (CDockManager::testConfigFlag(CDockManager::DragPreviewShowsContentPixmap))
+	// operations. If there is no snapshot yet, a plain frame is painted.
+	auto DockManager = qobject_cast<CDockManager*>(parent);
+	if (DockManager && CDockManager::testConfigFlag(CDockManager::DragPreviewShowsContentPixmap))
 	{
-		d->ContentPreviewPixmap = QPixmap(Content->size());
-		Content->render(&d->ContentPreviewPixmap);
+		d->ContentPreviewPixmap = DockManager->dragPreviewCache()->snapshot(Content);
 	}
 
 	connect(qApp, SIGNAL(applicationStateChanged(Qt::ApplicationState)),
@@ -374,8 +363,10 @@ void CFloatingDragPreview::startFloating(const QPoint &DragStartMousePos,
 {
 	Q_UNUSED(MouseEventHandler)
 	Q_UNUSED(DragState)
+	ADS_TRACE_SCOPE_CATEGORY("startFloating", "drag");
 	resize(Size);
 	d->DragStartMousePosition = DragStartMousePos;
+	d->DockManager->hitTestIndex()->beginDrag();
 	moveFloating();
 	show();
 
@@ -386,6 +377,7 @@ void CFloatingDragPreview::startFloating(const QPoint &DragStartMousePos,
 void CFloatingDragPreview::finishDragging()
 {
 	ADS_PRINT("CFloatingDragPreview::finishDragging");
+	ADS_TRACE_SCOPE_CATEGORY("finishDragging", "drag");
 
 	if (!d->DockManager->isDockingOnDragEnabled())
 	{
@@ -394,6 +386,7 @@ void CFloatingDragPreview::finishDragging()
 			d->createFloatingWidget();
 		}
 		this->close();
+		d->DockManager->hitTestIndex()->endDrag();
 		d->DockManager->containerOverlay()->hideOverlay();
 		d->DockManager->dockAreaOverlay()->hideOverlay();
 		return;
@@ -424,7 +417,7 @@ void CFloatingDragPreview::finishDragging()
 		CDockAreaWidget* DockArea = nullptr;
 		// If there is only one single dock area, and we drop into the center
 		// then we tabify the dropped widget into the only visible dock area
-		if (d->DropContainer->visibleDockAreaCount() <= 1 && CenterDockWidgetArea == ContainerDropArea)
+		if (d->DropContainer->layoutStatistics().VisibleDockAreas <= 1 && CenterDockWidgetArea == ContainerDropArea)
 		{
 			DockArea = d->DropContainer->dockAreaAt(QCursor::pos());
 		}
@@ -438,6 +431,7 @@ void CFloatingDragPreview::finishDragging()
 	}
 
 	this->close();
+	d->DockManager->hitTestIndex()->endDrag();
 	d->DockManager->containerOverlay()->hideOverlay();
 	d->DockManager->dockAreaOverlay()->hideOverlay();
 }
@@ -481,14 +475,17 @@ void CFloatingDragPreview::paintEvent(QPaintEvent* event)
 
 	QPainter painter(this);
 	painter.setOpacity(0.6);
-	if (CDockManager::testConfigFlag(CDockManager::DragPreviewShowsContentPixmap))
+	bool HasPixmap = !d->ContentPreviewPixmap.isNull();
+	if (HasPixmap)
 	{
-		painter.drawPixmap(QPoint(0, 0), d->ContentPreviewPixmap);
+		// The snapshot may have a lower resolution than the content
+		painter.setRenderHint(QPainter::SmoothPixmapTransform);
+		painter.drawPixmap(QRect(QPoint(0, 0), d->Content->size()), d->ContentPreviewPixmap);
 	}
 
-	// If we do not have a window frame then we paint a QRubberBand like
-	// frameless window
-	if (!CDockManager::testConfigFlag(CDockManager::DragPreviewHasWindowFrame))
+	// If we do not have a window frame or no content snapshot then we paint a
+	// QRubberBand like frameless window
+	if (!CDockManager::testConfigFlag(CDockManager::DragPreviewHasWindowFrame) || !HasPixmap)
 	{
 		QColor Color = palette().color(QPalette::Active, QPalette::Highlight);
 		QPen Pen = painter.pen();
@@ -0,0 +1,385 @@
+//============================================================================
+/// \file   PerspectiveStore.cpp
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Implementation of the perspective store classes
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include "PerspectiveStore.h"
+#include "DockingStateDelta.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QSaveFile>
+#include <QSet>
+
+namespace ads
+{
+/**
+ * File name suffix of the perspective files of a directory store
+ */
+static const char* const PerspectiveFileSuffix = ".perspective";
+
+/**
+ * File name suffix of the delta encoded perspective files of a directory
+ * store
+ */
+static const char* const DeltaFileSuffix = ".delta";
+
+
+//============================================================================
+bool IPerspectiveStore::isDeltaEncoded(const QString& Name) const
+{
+	return CDockingStateDelta::isDelta(perspective(Name));
+}
+
+
+/**
+ * Private data class of CMemoryPerspectiveStore class (pimpl)
+ */
+struct MemoryPerspectiveStorePrivate
+{
+	QMap<QString, QByteArray> Perspectives;
+};
+
+
+//============================================================================
+CMemoryPerspectiveStore::CMemoryPerspectiveStore() :
+	d(new MemoryPerspectiveStorePrivate())
+{
+
+}
+
+
+//============================================================================
+CMemoryPerspectiveStore::~CMemoryPerspectiveStore()
+{
+	delete d;
+}
+
+
+//============================================================================
+QStringList CMemoryPerspectiveStore::perspectiveNames() const
+{
+	return d->Perspectives.keys();
+}
+
+
+//============================================================================
+bool CMemoryPerspectiveStore::contains(const QString& Name) const
+{
+	return d->Perspectives.contains(Name);
+}
+
+
+//============================================================================
+QByteArray CMemoryPerspectiveStore::perspective(const QString& Name) const
+{
+	return d->Perspectives.value(Name);
+}
+
+
+//============================================================================
+void CMemoryPerspectiveStore::setPerspective(const QString& Name, const QByteArray& State)
+{
+	d->Perspectives.insert(Name, State);
+}
+
+
+//============================================================================
+bool CMemoryPerspectiveStore::removePerspective(const QString& Name)
+{
+	return d->Perspectives.remove(Name) > 0;
+}
+
+
+//============================================================================
+void CMemoryPerspectiveStore::clear()
+{
+	d->Perspectives.clear();
+}
+
+
+/**
+ * Private data class of CDirectoryPerspectiveStore class (pimpl)
+ */
+struct DirectoryPerspectiveStorePrivate
+{
+	QString DirectoryPath;
+	QSet<QString> Names;
+	QSet<QString> DeltaNames;
+	QMap<QString, QByteArray> ChangedPerspectives;
+	QSet<QString> RemovedPerspectives;
+
+	/**
+	 * Returns the file path of the perspective with the given name.
+	 * The file name is the hex encoded SHA-1 hash of the name. This gives
+	 * a valid file name with a fixed length on all platforms that is also
+	 * unique on case insensitive file systems. The name itself is stored
+	 * in the first line of the file.
+	 */
+	QString filePath(const QString& Name, bool Delta) const
+	{
+		auto Hash = QCryptographicHash::hash(Name.toUtf8(), QCryptographicHash::Sha1);
+		return QDir(DirectoryPath).filePath(QString::fromLatin1(Hash.toHex())
+			+ QLatin1String(Delta ? DeltaFileSuffix : PerspectiveFileSuffix));
+	}
+
+	/**
+	 * Reads the perspective name from the first line of the given file.
+	 * Returns an empty string, if the file is not a valid perspective file.
+	 */
+	static QString readName(QFile& File)
+	{
+		auto Line = File.readLine();
+		if (!Line.endsWith('\n'))
+		{
+			return QString();
+		}
+		Line.chop(1);
+		return QString::fromUtf8(QByteArray::fromPercentEncoding(Line));
+	}
+
+	/**
+	 * Adds the perspectives of all files with the given suffix in the
+	 * given directory. Only the first line of each file is read.
+	 */
+	void loadNames(const QDir& Dir, const char* Suffix, bool Delta)
+	{
+		const auto FileNames = Dir.entryList(
+			{QLatin1Char('*') + QLatin1String(Suffix)}, QDir::Files);
+		for (const auto& FileName : FileNames)
+		{
+			QFile File(Dir.filePath(FileName));
+			if (!File.open(QIODevice::ReadOnly))
+			{
+				continue;
+			}
+
+			auto Name = readName(File);
+			if (Name.isEmpty())
+			{
+				continue;
+			}
+
+			Names.insert(Name);
+			if (Delta)
+			{
+				DeltaNames.insert(Name);
+			}
+		}
+	}
+
+	/**
+	 * Removes the file of the perspective with the given name and the
+	 * given encoding if it exists
+	 */
+	bool removeFile(const QString& Name, bool Delta) const
+	{
+		QFile File(filePath(Name, Delta));
+		return !File.exists() || File.remove();
+	}
+};
+
+
+//============================================================================
+CDirectoryPerspectiveStore::CDirectoryPerspectiveStore(const QString& DirectoryPath) :
+	d(new DirectoryPerspectiveStorePrivate())
+{
+	d->DirectoryPath = DirectoryPath;
+}
+
+
+//============================================================================
+CDirectoryPerspectiveStore::~CDirectoryPerspectiveStore()
+{
+	delete d;
+}
+
+
+//============================================================================
+QString CDirectoryPerspectiveStore::directoryPath() const
+{
+	return d->DirectoryPath;
+}
+
+
+//============================================================================
+int CDirectoryPerspectiveStore::pendingChangeCount() const
+{
+	return d->ChangedPerspectives.count() + d->RemovedPerspectives.count();
+}
+
+
+//============================================================================
+QStringList CDirectoryPerspectiveStore::perspectiveNames() const
+{
+	QStringList Names = d->Names.values();
+	Names.sort();
+	return Names;
+}
+
+
+//============================================================================
+bool CDirectoryPerspectiveStore::contains(const QString& Name) const
+{
+	return d->Names.contains(Name);
+}
+
+
+//============================================================================
+QByteArray CDirectoryPerspectiveStore::perspective(const QString& Name) const
+{
+	if (!d->Names.contains(Name))
+	{
+		return QByteArray();
+	}
+
+	auto it = d->ChangedPerspectives.constFind(Name);
+	if (it != d->ChangedPerspectives.constEnd())
+	{
+		return it.value();
+	}
+
+	QFile File(d->filePath(Name, d->DeltaNames.contains(Name)));
+	if (!File.open(QIODevice::ReadOnly)
+	 || DirectoryPerspectiveStorePrivate::readName(File) != Name)
+	{
+		return QByteArray();
+	}
+	return File.readAll();
+}
+
+
+//============================================================================
+bool CDirectoryPerspectiveStore::isDeltaEncoded(const QString& Name) const
+{
+	return d->DeltaNames.contains(Name);
+}
+
+
+//============================================================================
+void CDirectoryPerspectiveStore::setPerspective(const QString& Name, const QByteArray& State)
+{
+	d->Names.insert(Name);
+	if (CDockingStateDelta::isDelta(State))
+	{
+		d->DeltaNames.insert(Name);
+	}
+	else
+	{
+		d->DeltaNames.remove(Name);
+	}
+	d->ChangedPerspectives.insert(Name, State);
+	d->RemovedPerspectives.remove(Name);
+}
+
+
+//============================================================================
+bool CDirectoryPerspectiveStore::removePerspective(const QString& Name)
+{
+	if (!d->Names.remove(Name))
+	{
+		return false;
+	}
+
+	d->DeltaNames.remove(Name);
+	d->ChangedPerspectives.remove(Name);
+	d->RemovedPerspectives.insert(Name);
+	return true;
+}
+
+
+//============================================================================
+void CDirectoryPerspectiveStore::clear()
+{
+	d->RemovedPerspectives.unite(d->Names);
+	d->Names.clear();
+	d->DeltaNames.clear();
+	d->ChangedPerspectives.clear();
+}
+
+
+//============================================================================
+bool CDirectoryPerspectiveStore::load()
+{
+	d->Names.clear();
+	d->DeltaNames.clear();
+	d->ChangedPerspectives.clear();
+	d->RemovedPerspectives.clear();
+
+	QDir Dir(d->DirectoryPath);
+	if (!Dir.exists())
+	{
+		return true;
+	}
+
+	d->loadNames(Dir, PerspectiveFileSuffix, false);
+	d->loadNames(Dir, DeltaFileSuffix, true);
+	return true;
+}
+
+
+//============================================================================
+bool CDirectoryPerspectiveStore::save()
+{
+	if (!pendingChangeCount())
+	{
+		return true;
+	}
+
+	if (!QDir().mkpath(d->DirectoryPath))
+	{
+		return false;
+	}
+
+	bool Result = true;
+	auto RemovedIt = d->RemovedPerspectives.begin();
+	while (RemovedIt != d->RemovedPerspectives.end())
+	{
+		if (!d->removeFile(*RemovedIt, false) || !d->removeFile(*RemovedIt, true))
+		{
+			Result = false;
+			++RemovedIt;
+		}
+		else
+		{
+			RemovedIt = d->RemovedPerspectives.erase(RemovedIt);
+		}
+	}
+
+	auto ChangedIt = d->ChangedPerspectives.begin();
+	while (ChangedIt != d->ChangedPerspectives.end())
+	{
+		// A perspective that changed its encoding leaves a file with the
+		// other suffix that needs to be removed
+		bool Delta = d->DeltaNames.contains(ChangedIt.key());
+		QSaveFile File(d->filePath(ChangedIt.key(), Delta));
+		auto Header = ChangedIt.key().toUtf8().toPercentEncoding() + '\n';
+		if (File.open(QIODevice::WriteOnly)
+		 && File.write(Header) == Header.size()
+		 && File.write(ChangedIt.value()) == ChangedIt.value().size()
+		 && File.commit()
+		 && d->removeFile(ChangedIt.key(), !Delta))
+		{
+			ChangedIt = d->ChangedPerspectives.erase(ChangedIt);
+		}
+		else
+		{
+			// Keep the perspective so that the next save() retries it
+			Result = false;
+			++ChangedIt;
+		}
+	}
+
+	return Result;
+}
+} // namespace ads
+
+//---------------------------------------------------------------------------
+// EOF PerspectiveStore.cpp
@@ -0,0 +1,176 @@
+#ifndef PerspectiveStoreH
+#define PerspectiveStoreH
+//============================================================================
+/// \file   PerspectiveStore.h
+/// \author agent
+/// \date   18.10.2026
+/// \brief  Declaration of the perspective store classes
+//============================================================================
+
+//============================================================================
+//                                   INCLUDES
+//============================================================================
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include "ads_globals.h"
+
+namespace ads
+{
+struct MemoryPerspectiveStorePrivate;
+struct DirectoryPerspectiveStorePrivate;
+
+/**
+ * Pure virtual interface for the storage of the perspectives of a dock
+ * manager.
+ * The dock manager asks the store for the state of a perspective only if
+ * the perspective is opened. This allows a store to load only the list of
+ * perspective names at startup and to read the state data on demand.
+ */
+class ADS_EXPORT IPerspectiveStore
+{
+public:
+	virtual ~IPerspectiveStore() = default;
+
+	/**
+	 * Returns the sorted names of all perspectives in the store
+	 */
+	virtual QStringList perspectiveNames() const = 0;
+
+	/**
+	 * Returns true, if the store contains a perspective with the given name
+	 */
+	virtual bool contains(const QString& Name) const = 0;
+
+	/**
+	 * Returns the saved state of the perspective with the given name or an
+	 * empty array if there is no such perspective
+	 */
+	virtual QByteArray perspective(const QString& Name) const = 0;
+
+	/**
+	 * Returns true, if the perspective with the given name is delta encoded
+	 * against a base perspective.
+	 * The default implementation checks the saved state. Stores that read
+	 * the state on demand should answer this from their index, because the
+	 * dock manager calls this for all perspectives to find the base
+	 * perspective.
+	 */
+	virtual bool isDeltaEncoded(const QString& Name) const;
+
+	/**
+	 * Inserts or replaces the perspective with the given name
+	 */
+	virtual void setPerspective(const QString& Name, const QByteArray& State) = 0;
+
+	/**
+	 * Removes the perspective with the given name.
+	 * Returns true, if the perspective existed
+	 */
+	virtual bool removePerspective(const QString& Name) = 0;
+
+	/**
+	 * Removes all perspectives
+	 */
+	virtual void clear() = 0;
+
+	/**
+	 * Loads the list of perspectives from the backing storage.
+	 * The default implementation does nothing and returns true.
+	 */
+	virtual bool load() {return true;}
+
+	/**
+	 * Writes the changed perspectives back into the backing storage.
+	 * The default implementation does nothing and returns true.
+	 */
+	virtual bool save() {return true;}
+};
+
+
+/**
+ * Perspective store that keeps all perspectives in memory.
+ * This is the default store of the dock manager. Use
+ * CDockManager::savePerspectives(QSettings&) and
+ * CDockManager::loadPerspectives(QSettings&) to persist the perspectives.
+ */
+class ADS_EXPORT CMemoryPerspectiveStore : public IPerspectiveStore
+{
+private:
+	MemoryPerspectiveStorePrivate* d; ///< private data (pimpl)
+
+public:
+	/**
+	 * Default Constructor
+	 */
+	CMemoryPerspectiveStore();
+
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~CMemoryPerspectiveStore();
+
+	virtual QStringList perspectiveNames() const override;
+	virtual bool contains(const QString& Name) const override;
+	virtual QByteArray perspective(const QString& Name) const override;
+	virtual void setPerspective(const QString& Name, const QByteArray& State) override;
+	virtual bool removePerspective(const QString& Name) override;
+	virtual void clear() override;
+};
+
+
+/**
+ * Perspective store that saves each perspective into its own file in a
+ * directory. The file name is the SHA-1 hash of the perspective name and
+ * the first line of the file contains the name. Delta encoded perspectives
+ * use a different file suffix, so the store knows them without reading the
+ * states.
+ * load() only reads the names from the first line of each file, the state
+ * of a perspective is read from its file when the perspective is opened.
+ * save() only writes the perspectives that have been added or changed and
+ * deletes the files of removed perspectives.
+ */
+class ADS_EXPORT CDirectoryPerspectiveStore : public IPerspectiveStore
+{
+private:
+	DirectoryPerspectiveStorePrivate* d; ///< private data (pimpl)
+	friend struct DirectoryPerspectiveStorePrivate;
+
+public:
+	/**
+	 * Creates a store for the given directory. The directory is created
+	 * by save() if it does not exist.
+	 */
+	CDirectoryPerspectiveStore(const QString& DirectoryPath);
+
+	/**
+	 * Virtual Destructor
+	 */
+	virtual ~CDirectoryPerspectiveStore();
+
+	/**
+	 * Returns the directory of this store
+	 */
+	QString directoryPath() const;
+
+	/**
+	 * Returns the number of perspectives that have been changed or removed
+	 * since the last load() or save()
+	 */
+	int pendingChangeCount() const;
+
+	virtual QStringList perspectiveNames() const override;
+	virtual bool contains(const QString& Name) const override;
+	virtual QByteArray perspective(const QString& Name) const override;
+	virtual bool isDeltaEncoded(const QString& Name) const override;
+	virtual void setPerspective(const QString& Name, const QByteArray& State) override;
+	virtual bool removePerspective(const QString& Name) override;
+	virtual void clear() override;
+	virtual bool load() override;
+	virtual bool save() override;
+};
+} // namespace ads
+
+//---------------------------------------------------------------------------
+#endif // PerspectiveStoreH
@@ -36,6 +36,7 @@
 #include "DockSplitter.h"
 #include "DockManager.h"
 #include "IconProvider.h"
+#include "DockTrace.h"
 #include "ads_globals.h"
 
 #if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
@@ -432,6 +433,7 @@ void repolishStyle(QWidget* w, eRepolishChildOptions Options)
 	{
 		return;
 	}
+	ADS_TRACE_SCOPE_CATEGORY("repolishStyle", "style");
 	w->style()->unpolish(w);
 	w->style()->polish(w);
 
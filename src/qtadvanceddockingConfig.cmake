@@ -1,2 +0,0 @@
-include(CMakeFindDependencyMacro)
-include("${CMAKE_CURRENT_LIST_DIR}/adsTargets.cmake")
\ No newline at end of file
@@ -38,6 +38,14 @@ HEADERS += \
     DockWidget.h \
     DockWidgetTab.h \ 
     DockingStateReader.h \
+    DockingStateBinary.h \
+    DockHitTestIndex.h \
+    DragPreviewCache.h \
+    DockTrace.h \
+    PerspectiveStore.h \
+    DockingStateDelta.h \
+    DockingStateWriter.h \
+    CompressionDevice.h \
     FloatingDockContainer.h \
     FloatingDragPreview.h \
     DockOverlay.h \
@@ -63,6 +71,14 @@ SOURCES += \
     DockManager.cpp \
     DockWidget.cpp \
     DockingStateReader.cpp \
+    DockingStateBinary.cpp \
+    DockHitTestIndex.cpp \
+    DragPreviewCache.cpp \
+    DockTrace.cpp \
+    PerspectiveStore.cpp \
+    DockingStateDelta.cpp \
+    DockingStateWriter.cpp \
+    CompressionDevice.cpp \
     DockWidgetTab.cpp \
     FloatingDockContainer.cpp \
     FloatingDragPreview.cpp \